@@ -3,49 +3,99 @@
 #include <algorithm>
 #include <utility>
 
+#include "calendar.h"
 #include "colony.h"
 #include "debug.h"
 #include "item.h"
 #include "item_stack.h"
 #include "safe_reference.h"
 
-void active_item_cache::remove( const item *it )
+active_item_cache::scheduled_item *active_item_cache::find_scheduled( const item *it )
 {
-    active_items[it->processing_speed()].remove_if( [it]( const item_reference & active_item ) {
-        item *const target = active_item.item_ref.get();
-        return !target || target == it;
+    const auto due = due_times.find( it );
+    if( due == due_times.end() ) {
+        return nullptr;
+    }
+    const auto bucket = scheduled.find( due->second );
+    if( bucket == scheduled.end() ) {
+        return nullptr;
+    }
+    const auto entry = std::find_if( bucket->second.begin(), bucket->second.end(),
+    [it]( const scheduled_item & elem ) {
+        return elem.target == it;
     } );
+    return entry != bucket->second.end() ? &*entry : nullptr;
 }
 
-void active_item_cache::add( item &it, point location )
+void active_item_cache::unschedule( const item *it )
 {
-    // If the item is alread in the cache for some reason, don't add a second reference
-    std::list<item_reference> &target_list = active_items[it.processing_speed()];
-    if( std::find_if( target_list.begin(),
-    target_list.end(), [&it]( const item_reference & active_item_ref ) {
-    return &it == active_item_ref.item_ref.get();
-    } ) != target_list.end() ) {
+    const auto due = due_times.find( it );
+    if( due == due_times.end() ) {
         return;
     }
-    target_list.push_back( item_reference{ location, it.get_safe_reference() } );
+    const auto bucket = scheduled.find( due->second );
+    if( bucket != scheduled.end() ) {
+        std::vector<scheduled_item> &refs = bucket->second;
+        refs.erase( std::remove_if( refs.begin(), refs.end(), [it]( const scheduled_item & elem ) {
+            return elem.target == it;
+        } ), refs.end() );
+        if( refs.empty() ) {
+            scheduled.erase( bucket );
+        }
+    }
+    due_times.erase( due );
+}
+
+void active_item_cache::schedule( const time_point &due, const scheduled_item &entry )
+{
+    scheduled[due].push_back( entry );
+    due_times[entry.target] = due;
+}
+
+void active_item_cache::remove( const item *it )
+{
+    unschedule( it );
+}
+
+void active_item_cache::add( item &it, point location )
+{
+    if( const scheduled_item *const existing = find_scheduled( &it ) ) {
+        // If the item is alread in the cache for some reason, don't add a second reference
+        if( existing->ref.item_ref.get() == &it ) {
+            return;
+        }
+        // A destroyed item that had the same address.
+        unschedule( &it );
+    }
+    const time_point wakeup = std::max( it.next_processing_time(), time_point( calendar::turn ) );
+    schedule( wakeup, scheduled_item{ item_reference{ location, it.get_safe_reference() }, &it } );
 }
 
 bool active_item_cache::empty() const
 {
-    return active_items.empty();
+    return scheduled.empty();
 }
 
 std::vector<item_reference> active_item_cache::get()
 {
     std::vector<item_reference> all_cached_items;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        for( std::list<item_reference>::iterator it = kv.second.begin(); it != kv.second.end(); ) {
-            if( it->item_ref ) {
-                all_cached_items.emplace_back( *it );
-                ++it;
-            } else {
-                it = kv.second.erase( it );
+    for( auto bucket = scheduled.begin(); bucket != scheduled.end(); ) {
+        std::vector<scheduled_item> &refs = bucket->second;
+        refs.erase( std::remove_if( refs.begin(), refs.end(),
+        [this]( const scheduled_item & active_item ) {
+            if( active_item.ref.item_ref ) {
+                return false;
             }
+            due_times.erase( active_item.target );
+            return true;
+        } ), refs.end() );
+        for( const scheduled_item &elem : refs ) {
+            all_cached_items.push_back( elem.ref );
+        }
+        if( refs.empty() ) {
+            bucket = scheduled.erase( bucket );
+        } else {
+            ++bucket;
         }
     }
     return all_cached_items;
@@ -53,42 +103,62 @@ std::vector<item_reference> active_item_cache::get()
 
 std::vector<item_reference> active_item_cache::get_for_processing()
 {
+    const time_point now = calendar::turn;
+    if( now < last_processing && !scheduled.empty() ) {
+        // The time has been set back, wake everything up so nothing sleeps until the old time.
+        std::vector<scheduled_item> all_items;
+        for( auto &bucket : scheduled ) {
+            all_items.insert( all_items.end(), bucket.second.begin(), bucket.second.end() );
+        }
+        scheduled.clear();
+        due_times.clear();
+        for( const scheduled_item &elem : all_items ) {
+            schedule( now, elem );
+        }
+    }
+    last_processing = now;
+
     std::vector<item_reference> items_to_process;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        // Rely on iteration logic to make sure the number is sane.
-        int num_to_process = kv.second.size() / kv.first;
-        std::list<item_reference>::iterator it = kv.second.begin();
-        for( ; it != kv.second.end() && num_to_process >= 0; ) {
-            if( it->item_ref ) {
-                items_to_process.push_back( *it );
-                --num_to_process;
-                ++it;
-            } else {
-                // The item has been destroyed, so remove the reference from the cache
-                it = kv.second.erase( it );
+    std::vector<std::pair<time_point, scheduled_item>> rescheduled;
+    while( !scheduled.empty() && scheduled.begin()->first <= now ) {
+        for( scheduled_item &elem : scheduled.begin()->second ) {
+            if( !elem.ref.item_ref ) {
+                // The item has been destroyed, so drop the reference from the cache
+                due_times.erase( elem.target );
+                continue;
+            }
+            const time_point wakeup = elem.ref.item_ref->next_processing_time();
+            if( wakeup > now ) {
+                // Nothing to do for this item yet, for example because it has just been
+                // processed. Let it sleep until then.
+                rescheduled.emplace_back( wakeup, elem );
+                continue;
             }
+            items_to_process.push_back( elem.ref );
+            rescheduled.emplace_back( now + 1_turns, elem );
         }
-        // Rotate the returned items to the end of their list so that the items that weren't
-        // returned this time will be first in line on the next call
-        kv.second.splice( kv.second.end(), kv.second, kv.second.begin(), it );
+        scheduled.erase( scheduled.begin() );
+    }
+    for( const std::pair<time_point, scheduled_item> &elem : rescheduled ) {
+        schedule( elem.first, elem.second );
     }
     return items_to_process;
 }
 
 void active_item_cache::subtract_locations( const point &delta )
 {
-    for( auto &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location -= delta;
+    for( auto &bucket : scheduled ) {
+        for( scheduled_item &elem : bucket.second ) {
+            elem.ref.location -= delta;
         }
     }
 }
 
 void active_item_cache::rotate_locations( int turns, const point &dim )
 {
-    for( auto &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location = ir.location.rotate( turns, dim );
+    for( auto &bucket : scheduled ) {
+        for( scheduled_item &elem : bucket.second ) {
+            elem.ref.location = elem.ref.location.rotate( turns, dim );
         }
     }
 }
@@ -2,9 +2,11 @@
 #ifndef ACTIVE_ITEM_CACHE_H
 #define ACTIVE_ITEM_CACHE_H
 
-#include <list>
+#include <map>
 #include <unordered_map>
+#include <vector>
 
+#include "calendar.h"
 #include "colony.h"
 #include "enums.h"
 #include "item.h"
@@ -20,19 +22,39 @@ struct item_reference {
 class active_item_cache
 {
     private:
-        std::unordered_map<int, std::list<item_reference>> active_items;
+        struct scheduled_item {
+            item_reference ref;
+            // The item ref pointed to when it was added, it can't be asked once the item is gone.
+            const item *target;
+        };
+        /**
+         * The active items, bucketed by the turn on which they next need processing, see
+         * @ref item::next_processing_time. Items that don't do anything most turns sleep in
+         * a later bucket instead of being looked at every turn.
+         */
+        std::map<time_point, std::vector<scheduled_item>> scheduled;
+        /** The bucket of each item in @ref scheduled, so it is found without a search. */
+        std::unordered_map<const item *, time_point> due_times;
+        /**
+         * The entry of @p it in @ref scheduled, or null. The entry may be that of a destroyed
+         * item that had the same address.
+         */
+        scheduled_item *find_scheduled( const item *it );
+        /** Removes the entry of @p it from @ref scheduled and @ref due_times, if it has one. */
+        void unschedule( const item *it );
+        void schedule( const time_point &due, const scheduled_item &entry );
+
+        /** The turn @ref get_for_processing was last called on. */
+        time_point last_processing = calendar::before_time_starts;
 
     public:
         /**
          * Removes the item if it is in the cache. Does nothing if the item is not in the cache.
-         * Relies on the fact that item::processing_speed() is a constant.
-         * Also removes any items that have been destroyed in the list containing it
          */
         void remove( const item *it );
 
         /**
          * Adds the reference to the cache. Does nothing if the reference is already in the cache.
-         * Relies on the fact that item::processing_speed() is a constant.
          */
         void add( item &it, point location );
 
@@ -48,12 +70,12 @@ class active_item_cache
         std::vector<item_reference> get();
 
         /**
-         * Returns the first size() / processing_speed() elements of each list, rounded up.
-         * Items returned are rotated to the back of their respective lists, otherwise only the
-         * first n items will ever be processed.
+         * Returns the items that are due for processing on the current turn.
+         * They are checked again on the next turn, by then processing has updated what
+         * @ref item::next_processing_time depends on, so items that don't need processing
+         * then are put to sleep until they do.
          * Broken references encountered when collecting the items to be processed are removed from
          * the cache.
-         * Relies on the fact that item::processing_speed() is a constant.
          */
         std::vector<item_reference> get_for_processing();
 
@@ -18,6 +18,7 @@
 #include "options.h"
 #include "output.h"
 #include "rng.h"
+#include "save_writer.h"
 #include "translations.h"
 #include "units.h"
 #include "catacharset.h"
@@ -348,9 +349,7 @@ bool write_to_file( const std::string &path, const std::function<void( std::ostr
                     const char *const fail_message )
 {
     try {
-        ofstream_wrapper fout( path );
-        writer( fout.stream() );
-        fout.close();
+        write_save_file( path, writer, false );
         return true;
 
     } catch( const std::exception &err ) {
@@ -389,9 +388,7 @@ bool write_to_file_exclusive( const std::string &path,
                               const std::function<void( std::ostream & )> &writer, const char *const fail_message )
 {
     try {
-        ofstream_wrapper_exclusive fout( path );
-        writer( fout.stream() );
-        fout.close();
+        write_save_file( path, writer, true );
         return true;
 
     } catch( const std::exception &err ) {
@@ -381,6 +381,7 @@ class ofstream_wrapper
  * If the writer throws, or if the file could not be opened or if any I/O error
  * happens, the function shows a popup containing the
  * \p fail_message, the error text and the path.
+ * During a background save (see @ref save_writer) the output is queued instead of written.
  *
  * @return Whether saving succeeded (no error was caught).
  */
@@ -839,6 +839,7 @@ class Character : public Creature, public visitable<Character>
         void on_damage_of_type( int adjusted_damage, damage_type type, body_part bp ) override;
         virtual void on_mutation_gain( const trait_id & ) {}
         virtual void on_mutation_loss( const trait_id & ) {}
+        virtual void on_mutations_changed() {}
     public:
         virtual void on_item_wear( const item & ) {}
         virtual void on_item_takeoff( const item & ) {}
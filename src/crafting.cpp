@@ -485,6 +485,7 @@ const inventory &player::crafting_inventory( const tripoint &src_pos, int radius
         return cached_crafting_inventory;
     }
     cached_crafting_inventory.form_from_map( inv_pos, radius, false );
+    cached_requirement_lookups->clear();
     cached_crafting_inventory += inv;
     cached_crafting_inventory += weapon;
     cached_crafting_inventory += worn;
@@ -512,6 +513,13 @@ void player::invalidate_crafting_inventory()
     cached_time = calendar::before_time_starts;
 }
 
+bool player::is_recipe_available( const recipe &r )
+{
+    const inventory &crafting_inv = crafting_inventory();
+    return cached_requirement_lookups->can_make( r.requirements(), crafting_inv,
+            r.get_component_filter() );
+}
+
 void player::make_craft( const recipe_id &id_to_make, int batch_size, const tripoint &loc )
 {
     make_craft_with_command( id_to_make, batch_size, false, loc );
@@ -375,8 +375,7 @@ const recipe *select_crafting_recipe( int &batch_size )
                 // cache recipe availability on first display
                 for( const auto e : current ) {
                     if( !availability_cache.count( e ) ) {
-                        availability_cache.emplace( e, e->requirements().can_make_with_inventory( crafting_inv,
-                                                    e->get_component_filter() ) );
+                        availability_cache.emplace( e, g->u.is_recipe_available( *e ) );
                     }
                 }
 
@@ -1,11 +1,14 @@
 #include "creature_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <ostream>
 #include <string>
 #include <utility>
 
+#include "coordinate_conversions.h"
 #include "debug.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -82,6 +85,7 @@ bool Creature_tracker::add( monster &critter )
 
     monsters_list.emplace_back( std::make_shared<monster>( critter ) );
     monsters_by_location[critter.pos()] = monsters_list.back();
+    add_to_submap_index( *monsters_list.back(), critter.pos() );
     return true;
 }
 
@@ -118,6 +122,8 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
     if( iter != monsters_list.end() ) {
         monsters_by_location.erase( critter.pos() );
         monsters_by_location[new_pos] = *iter;
+        remove_from_submap_index( critter );
+        add_to_submap_index( **iter, new_pos );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -141,6 +147,41 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
             monsters_by_location.erase( pos_iter );
         }
     }
+    remove_from_submap_index( critter );
+}
+
+void Creature_tracker::add_to_submap_index( monster &critter, const tripoint &pos )
+{
+    const int z = pos.z + OVERMAP_DEPTH;
+    if( z < 0 || z >= OVERMAP_LAYERS ) {
+        return;
+    }
+    const point sm = ms_to_sm_copy( point( pos.x, pos.y ) );
+    monsters_by_submap[z][sm].push_back( &critter );
+    submap_of_monster[&critter] = tripoint( sm, pos.z );
+}
+
+void Creature_tracker::remove_from_submap_index( const monster &critter )
+{
+    // Look the monster up under the submap it was filed under, its position may have been
+    // changed without telling us (e.g. when the map is shifted).
+    const auto filed_iter = submap_of_monster.find( &critter );
+    if( filed_iter == submap_of_monster.end() ) {
+        return;
+    }
+    const tripoint sm = filed_iter->second;
+    submap_of_monster.erase( filed_iter );
+
+    auto &layer = monsters_by_submap[sm.z + OVERMAP_DEPTH];
+    const auto bucket_iter = layer.find( point( sm.x, sm.y ) );
+    if( bucket_iter == layer.end() ) {
+        return;
+    }
+    std::vector<monster *> &bucket = bucket_iter->second;
+    bucket.erase( std::remove( bucket.begin(), bucket.end(), &critter ), bucket.end() );
+    if( bucket.empty() ) {
+        layer.erase( bucket_iter );
+    }
 }
 
 void Creature_tracker::remove( const monster &critter )
@@ -162,16 +203,130 @@ void Creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    for( auto &layer : monsters_by_submap ) {
+        layer.clear();
+    }
+    submap_of_monster.clear();
 }
 
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    for( auto &layer : monsters_by_submap ) {
+        layer.clear();
+    }
+    submap_of_monster.clear();
     for( const std::shared_ptr<monster> &mon_ptr : monsters_list ) {
         monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        if( !mon_ptr->is_dead() ) {
+            add_to_submap_index( *mon_ptr, mon_ptr->pos() );
+        }
     }
 }
 
+std::vector<monster *> Creature_tracker::find_all_in_radius( const tripoint &center,
+        const int radius ) const
+{
+    std::vector<std::pair<int, monster *>> found;
+    if( radius < 0 ) {
+        return {};
+    }
+    const point min_sm = ms_to_sm_copy( point( center.x - radius, center.y - radius ) );
+    const point max_sm = ms_to_sm_copy( point( center.x + radius, center.y + radius ) );
+    const int num_buckets = ( max_sm.x - min_sm.x + 1 ) * ( max_sm.y - min_sm.y + 1 );
+    const auto add_bucket = [&]( const std::vector<monster *> &bucket ) {
+        for( monster *const critter : bucket ) {
+            const int dist = rl_dist( center, critter->pos() );
+            if( dist <= radius && !critter->is_dead() ) {
+                found.emplace_back( dist, critter );
+            }
+        }
+    };
+
+    const int min_z = std::max( center.z - radius, -OVERMAP_DEPTH );
+    const int max_z = std::min( center.z + radius, OVERMAP_HEIGHT );
+    for( int z = min_z; z <= max_z; z++ ) {
+        const auto &layer = monsters_by_submap[z + OVERMAP_DEPTH];
+        if( static_cast<int>( layer.size() ) < num_buckets ) {
+            // Fewer occupied submaps than submaps in range, cheaper to walk the occupied ones.
+            for( const auto &bucket : layer ) {
+                if( bucket.first.x >= min_sm.x && bucket.first.x <= max_sm.x &&
+                    bucket.first.y >= min_sm.y && bucket.first.y <= max_sm.y ) {
+                    add_bucket( bucket.second );
+                }
+            }
+        } else {
+            for( int y = min_sm.y; y <= max_sm.y; y++ ) {
+                for( int x = min_sm.x; x <= max_sm.x; x++ ) {
+                    const auto bucket_iter = layer.find( point( x, y ) );
+                    if( bucket_iter != layer.end() ) {
+                        add_bucket( bucket_iter->second );
+                    }
+                }
+            }
+        }
+    }
+
+    std::stable_sort( found.begin(), found.end(),
+    []( const std::pair<int, monster *> &lhs, const std::pair<int, monster *> &rhs ) {
+        return lhs.first < rhs.first;
+    } );
+    std::vector<monster *> result;
+    result.reserve( found.size() );
+    for( const auto &elem : found ) {
+        result.push_back( elem.second );
+    }
+    return result;
+}
+
+monster *Creature_tracker::find_nearest( const tripoint &center, const int radius,
+        const std::function<bool( const monster & )> &pred ) const
+{
+    if( radius < 0 ) {
+        return nullptr;
+    }
+    const point center_sm = ms_to_sm_copy( point( center.x, center.y ) );
+    const point min_sm = ms_to_sm_copy( point( center.x - radius, center.y - radius ) );
+    const point max_sm = ms_to_sm_copy( point( center.x + radius, center.y + radius ) );
+    const int max_ring = std::max( { center_sm.x - min_sm.x, max_sm.x - center_sm.x,
+                                     center_sm.y - min_sm.y, max_sm.y - center_sm.y
+                                   } );
+    const int min_z = std::max( center.z - radius, -OVERMAP_DEPTH );
+    const int max_z = std::min( center.z + radius, OVERMAP_HEIGHT );
+
+    monster *best = nullptr;
+    int best_dist = radius + 1;
+    for( int ring = 0; ring <= max_ring; ring++ ) {
+        // Every tile of a submap in this ring is at least this far away from the center.
+        if( ring > 0 && ( ring - 1 ) * std::min( SEEX, SEEY ) + 1 >= best_dist ) {
+            break;
+        }
+        for( int dy = -ring; dy <= ring; dy++ ) {
+            // Only the first and last row are walked completely, the others only have
+            // their two outermost submaps in this ring.
+            const int step = std::abs( dy ) == ring ? 1 : 2 * ring;
+            for( int dx = -ring; dx <= ring; dx += step ) {
+                const point sm( center_sm.x + dx, center_sm.y + dy );
+                for( int z = min_z; z <= max_z; z++ ) {
+                    const auto &layer = monsters_by_submap[z + OVERMAP_DEPTH];
+                    const auto bucket_iter = layer.find( sm );
+                    if( bucket_iter == layer.end() ) {
+                        continue;
+                    }
+                    for( monster *const critter : bucket_iter->second ) {
+                        const int dist = rl_dist( center, critter->pos() );
+                        if( dist < best_dist && !critter->is_dead() && pred( *critter ) ) {
+                            best = critter;
+                            best_dist = dist;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
 void Creature_tracker::swap_positions( monster &first, monster &second )
 {
     if( first.pos() == second.pos() ) {
@@ -195,6 +350,12 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
         monsters_by_location.erase( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
+    if( first_ptr ) {
+        remove_from_submap_index( *first_ptr );
+    }
+    if( second_ptr ) {
+        remove_from_submap_index( *second_ptr );
+    }
 
     tripoint temp = second.pos();
     second.spawn( first.pos() );
@@ -203,9 +364,11 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
         monsters_by_location[first.pos()] = first_ptr;
+        add_to_submap_index( *first_ptr, first_ptr->pos() );
     }
     if( second_ptr ) {
         monsters_by_location[second.pos()] = second_ptr;
+        add_to_submap_index( *second_ptr, second_ptr->pos() );
     }
 }
 
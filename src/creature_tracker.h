@@ -2,12 +2,15 @@
 #ifndef CREATURE_TRACKER_H
 #define CREATURE_TRACKER_H
 
+#include <array>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "enums.h"
+#include "game_constants.h"
 #include "point.h"
 
 class monster;
@@ -51,6 +54,19 @@ class Creature_tracker
         /** Removes dead monsters from. Their pointers are invalidated. */
         void remove_dead();
 
+        /**
+         * Returns the live monsters within @p radius (as per @ref rl_dist) of @p center,
+         * nearest first. Only the submap buckets that overlap the radius are looked at.
+         */
+        std::vector<monster *> find_all_in_radius( const tripoint &center, int radius ) const;
+        /**
+         * Returns the nearest live monster within @p radius of @p center for which @p pred
+         * returns true, or `nullptr` if there is none. Buckets are searched outward from
+         * @p center, monsters in buckets further away than the best match are skipped.
+         */
+        monster *find_nearest( const tripoint &center, int radius,
+                               const std::function<bool( const monster & )> &pred ) const;
+
         const std::vector<std::shared_ptr<monster>> &get_monsters_list() const {
             return monsters_list;
         }
@@ -61,8 +77,17 @@ class Creature_tracker
     private:
         std::vector<std::shared_ptr<monster>> monsters_list;
         std::unordered_map<tripoint, std::shared_ptr<monster>> monsters_by_location;
-        /** Remove the monsters entry in @ref monsters_by_location */
+        /**
+         * Live monsters bucketed by the submap they are on, one map per z-level.
+         * Kept in sync with @ref monsters_by_location.
+         */
+        std::array<std::unordered_map<point, std::vector<monster *>>, OVERMAP_LAYERS> monsters_by_submap;
+        /** The submap (and z-level) each monster in @ref monsters_by_submap is filed under. */
+        std::unordered_map<const monster *, tripoint> submap_of_monster;
+        /** Remove the monsters entry in @ref monsters_by_location and @ref monsters_by_submap */
         void remove_from_location_map( const monster &critter );
+        void add_to_submap_index( monster &critter, const tripoint &pos );
+        void remove_from_submap_index( const monster &critter );
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "input.h"
 #include "line.h"
 #include "map.h"
+#include "mapbuffer.h"
 #include "mapdata.h"
 #include "monster.h"
 #include "npc.h"
@@ -1752,6 +1753,11 @@ int editmap::mapgen_preview( const real_coords &tc, uilist &gmenu )
                         }
 
                         g->m.update_vehicle_list( destsm, target.z ); // update real map's vcaches
+                        // The swap bypasses the map buffer, update its vehicle registry
+                        const tripoint abs_sub = g->m.get_abs_sub();
+                        const tripoint abs_dest( abs_sub.x + dest_pos.x, abs_sub.y + dest_pos.y,
+                                                 dest_pos.z );
+                        MAPBUFFER.vehicles_changed( abs_dest );
 
                         if( !destsm->spawns.empty() ) {                              // trigger spawnpoints
                             g->m.spawn_monsters( true );
@@ -1981,7 +1987,7 @@ void editmap::cleartmpmap( tinymap &tmpmap )
     }
 
     auto &ch = tmpmap.get_cache( target.z );
-    std::memset( ch.veh_exists_at, 0, sizeof( ch.veh_exists_at ) );
+    std::memset( ch.veh_part_index, 0, sizeof( ch.veh_part_index ) );
     ch.veh_cached_parts.clear();
     ch.vehicle_list.clear();
     ch.zone_vehicles.clear();
@@ -533,8 +533,60 @@ time_duration field_entry::set_field_age( const time_duration &new_age )
 }
 
 field::field()
-    : _displayed_field_type( fd_null )
+    : _field_count( 0 ), _displayed_field_type( fd_null )
 {
+    _inline_fields.fill( value_type( fd_null, field_entry() ) );
+}
+
+field::field( const field &other )
+    : _inline_fields( other._inline_fields ), _field_count( other._field_count ),
+      _displayed_field_type( other._displayed_field_type )
+{
+    if( other._more_fields ) {
+        _more_fields.reset( new std::deque<value_type>( *other._more_fields ) );
+    }
+}
+
+field &field::operator=( const field &other )
+{
+    if( this != &other ) {
+        *this = field( other );
+    }
+    return *this;
+}
+
+field::value_type *field::find_slot( const field_id type )
+{
+    for( value_type &fld : _inline_fields ) {
+        if( fld.first == type ) {
+            return &fld;
+        }
+    }
+    if( _more_fields ) {
+        for( value_type &fld : *_more_fields ) {
+            if( fld.first == type ) {
+                return &fld;
+            }
+        }
+    }
+    return nullptr;
+}
+
+const field::value_type *field::find_slot( const field_id type ) const
+{
+    return const_cast<field *>( this )->find_slot( type );
+}
+
+size_t field::next_slot( const field_id type ) const
+{
+    size_t next = no_slot;
+    for( size_t i = 0; i < slot_count(); i++ ) {
+        const field_id slot_type = slot( i ).first;
+        if( slot_type > type && ( next == no_slot || slot_type < slot( next ).first ) ) {
+            next = i;
+        }
+    }
+    return next;
 }
 
 /*
@@ -544,20 +596,20 @@ Good for checking for existence of a field: if(myfield.find_field(fd_fire)) woul
 */
 field_entry *field::find_field( const field_id field_to_find )
 {
-    const auto it = _field_type_list.find( field_to_find );
-    if( it != _field_type_list.end() ) {
-        return &it->second;
+    if( field_to_find == fd_null ) {
+        return nullptr;
     }
-    return nullptr;
+    value_type *const fld = find_slot( field_to_find );
+    return fld ? &fld->second : nullptr;
 }
 
 const field_entry *field::find_field_c( const field_id field_to_find ) const
 {
-    const auto it = _field_type_list.find( field_to_find );
-    if( it != _field_type_list.end() ) {
-        return &it->second;
+    if( field_to_find == fd_null ) {
+        return nullptr;
     }
-    return nullptr;
+    const value_type *const fld = find_slot( field_to_find );
+    return fld ? &fld->second : nullptr;
 }
 
 const field_entry *field::find_field( const field_id field_to_find ) const
@@ -576,42 +628,63 @@ Intensity defaults to 1, and age to 0 (permanent) if not specified.
 bool field::add_field( const field_id field_to_add, const int new_intensity,
                        const time_duration &new_age )
 {
-    auto it = _field_type_list.find( field_to_add );
+    if( field_to_add == fd_null ) {
+        return false;
+    }
     if( all_field_types_enum_list[field_to_add].priority >=
         all_field_types_enum_list[_displayed_field_type].priority ) {
         _displayed_field_type = field_to_add;
     }
-    if( it != _field_type_list.end() ) {
+    if( field_entry *const existing = find_field( field_to_add ) ) {
         //Already exists, but lets update it. This is tentative.
-        it->second.set_field_intensity( it->second.get_field_intensity() + new_intensity );
+        existing->set_field_intensity( existing->get_field_intensity() + new_intensity );
         return false;
     }
-    _field_type_list[field_to_add] = field_entry( field_to_add, new_intensity, new_age );
+    const value_type added( field_to_add, field_entry( field_to_add, new_intensity, new_age ) );
+    _field_count++;
+    // Reuse the first free slot, existing entries must not move.
+    value_type *const free_slot = find_slot( fd_null );
+    if( free_slot ) {
+        *free_slot = added;
+        return true;
+    }
+    if( !_more_fields ) {
+        _more_fields.reset( new std::deque<value_type>() );
+    }
+    _more_fields->push_back( added );
     return true;
 }
 
 bool field::remove_field( field_id const field_to_remove )
 {
-    const auto it = _field_type_list.find( field_to_remove );
-    if( it == _field_type_list.end() ) {
-        return false;
+    for( iterator it = begin(); it != end(); ++it ) {
+        if( it->first == field_to_remove ) {
+            remove_field( it );
+            return true;
+        }
     }
-    remove_field( it );
-    return true;
+    return false;
 }
 
-void field::remove_field( std::map<field_id, field_entry>::iterator const it )
+void field::remove_field( const iterator it )
 {
-    _field_type_list.erase( it );
-    if( _field_type_list.empty() ) {
-        _displayed_field_type = fd_null;
-    } else {
-        _displayed_field_type = fd_null;
-        for( auto &fld : _field_type_list ) {
-            if( all_field_types_enum_list[fld.first].priority >=
-                all_field_types_enum_list[_displayed_field_type].priority ) {
-                _displayed_field_type = fld.first;
-            }
+    it->first = fd_null;
+    it->second = field_entry();
+    _field_count--;
+    if( _field_count == 0 ) {
+        // Free slots are kept while the tile has fields, so other entries stay in place.
+        _more_fields.reset();
+    }
+    update_displayed_field_type();
+}
+
+void field::update_displayed_field_type()
+{
+    _displayed_field_type = fd_null;
+    for( const value_type &fld : *this ) {
+        if( all_field_types_enum_list[fld.first].priority >=
+            all_field_types_enum_list[_displayed_field_type].priority ) {
+            _displayed_field_type = fld.first;
         }
     }
 }
@@ -622,27 +695,27 @@ Returns the number of fields existing on the current tile.
 */
 unsigned int field::field_count() const
 {
-    return _field_type_list.size();
+    return _field_count;
 }
 
-std::map<field_id, field_entry>::iterator field::begin()
+field::iterator field::begin()
 {
-    return _field_type_list.begin();
+    return iterator( *this, next_slot( fd_null ) );
 }
 
-std::map<field_id, field_entry>::const_iterator field::begin() const
+field::const_iterator field::begin() const
 {
-    return _field_type_list.begin();
+    return const_iterator( *this, next_slot( fd_null ) );
 }
 
-std::map<field_id, field_entry>::iterator field::end()
+field::iterator field::end()
 {
-    return _field_type_list.end();
+    return iterator( *this, no_slot );
 }
 
-std::map<field_id, field_entry>::const_iterator field::end() const
+field::const_iterator field::end() const
 {
-    return _field_type_list.end();
+    return const_iterator( *this, no_slot );
 }
 
 std::string field_t::name( const int intensity ) const
@@ -663,7 +736,7 @@ field_id field::displayed_field_type() const
 int field::move_cost() const
 {
     int current_cost = 0;
-    for( auto &fld : _field_type_list ) {
+    for( auto &fld : *this ) {
         current_cost += fld.second.move_cost();
     }
     return current_cost;
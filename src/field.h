@@ -3,9 +3,14 @@
 #define FIELD_H
 
 #include <array>
-#include <map>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 
 #include "calendar.h"
 #include "color.h"
@@ -209,11 +214,80 @@ class field_entry
  * Use @ref find_field to get the field entry of a specific type, or iterate over
  * all entries via @ref begin and @ref end (allows range based iteration).
  * There is @ref displayed_field_type to specific which field should be drawn on the map.
+ *
+ * The first few entries are stored in the field itself, so most tiles with fields don't
+ * allocate anything. Entries never move once added: references to them and iterators
+ * stay valid while other entries are added or removed (only the removed entry is gone),
+ * as field processing adds fields to the tile it is iterating over.
 */
 class field
 {
     public:
+        using value_type = std::pair<field_id, field_entry>;
+
+        template<typename Field, typename Value>
+        class slot_iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = field::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Value *;
+                using reference = Value &;
+
+                slot_iterator( Field &fld, size_t index ) : fld( &fld ), index( index ),
+                    type( at_end() ? fd_null : fld.slot( index ).first ) {}
+                // allows converting iterator to const_iterator
+                template<typename OtherField, typename OtherValue>
+                slot_iterator( const slot_iterator<OtherField, OtherValue> &other ) :
+                    fld( other.fld ), index( other.index ), type( other.type ) {}
+
+                reference operator*() const {
+                    return fld->slot( index );
+                }
+                pointer operator->() const {
+                    return &fld->slot( index );
+                }
+                slot_iterator &operator++() {
+                    // uses the remembered type, the entry may have been removed since
+                    index = fld->next_slot( type );
+                    type = at_end() ? fd_null : fld->slot( index ).first;
+                    return *this;
+                }
+                slot_iterator operator++( int ) {
+                    slot_iterator result = *this;
+                    ++*this;
+                    return result;
+                }
+                bool operator==( const slot_iterator &rhs ) const {
+                    return index == rhs.index || ( at_end() && rhs.at_end() );
+                }
+                bool operator!=( const slot_iterator &rhs ) const {
+                    return !( *this == rhs );
+                }
+
+            private:
+                template<typename, typename>
+                friend class slot_iterator;
+                friend class field;
+
+                Field *fld;
+                size_t index;
+                // type of the entry the iterator points to
+                field_id type;
+
+                bool at_end() const {
+                    return index >= fld->slot_count();
+                }
+        };
+        using iterator = slot_iterator<field, value_type>;
+        using const_iterator = slot_iterator<const field, const value_type>;
+
         field();
+        field( const field &other );
+        field &operator=( const field &other );
+        field( field && ) = default;
+        field &operator=( field && ) = default;
 
         /**
          * Returns a field entry corresponding to the field_id parameter passed in.
@@ -250,9 +324,10 @@ class field
         bool remove_field( field_id field_to_remove );
         /**
          * Make sure to decrement the field counter in the submap.
-         * Removes the field entry, the iterator must point into @ref _field_type_list and must be valid.
+         * Removes the field entry, the iterator must point into this field and must be valid.
+         * Other iterators stay valid, except those pointing to the removed entry.
          */
-        void remove_field( std::map<field_id, field_entry>::iterator );
+        void remove_field( iterator it );
 
         //Returns the number of fields existing on the current tile.
         unsigned int field_count() const;
@@ -262,13 +337,13 @@ class field
          */
         field_id displayed_field_type() const;
 
-        //Returns the vector iterator to begin searching through the list.
-        std::map<field_id, field_entry>::iterator begin();
-        std::map<field_id, field_entry>::const_iterator begin() const;
+        //Returns the iterator to begin searching through the list.
+        iterator begin();
+        const_iterator begin() const;
 
-        //Returns the vector iterator to end searching through the list.
-        std::map<field_id, field_entry>::iterator end();
-        std::map<field_id, field_entry>::const_iterator end() const;
+        //Returns the iterator to end searching through the list.
+        iterator end();
+        const_iterator end() const;
 
         /**
          * Returns the total move cost from all fields.
@@ -276,10 +351,36 @@ class field
         int move_cost() const;
 
     private:
-        // A pointer lookup table of all field effects on the current tile.
-        std::map<field_id, field_entry> _field_type_list;
+        static constexpr size_t inline_slots = 2;
+        // The field effects on the current tile, unused slots have the type fd_null.
+        std::array<value_type, inline_slots> _inline_fields;
+        // Slots for more field effects than fit into _inline_fields, usually not allocated.
+        std::unique_ptr<std::deque<value_type>> _more_fields;
+        unsigned char _field_count;
         // _displayed_field_type is equal to the last field added to the square. You can modify this behavior in the class functions if you wish.
         field_id _displayed_field_type;
+
+        size_t slot_count() const {
+            return inline_slots + ( _more_fields ? _more_fields->size() : 0 );
+        }
+        value_type &slot( size_t index ) {
+            return index < inline_slots ? _inline_fields[index] :
+                   ( *_more_fields )[index - inline_slots];
+        }
+        const value_type &slot( size_t index ) const {
+            return index < inline_slots ? _inline_fields[index] :
+                   ( *_more_fields )[index - inline_slots];
+        }
+        value_type *find_slot( field_id type );
+        const value_type *find_slot( field_id type ) const;
+        /**
+         * Index of the slot with the lowest type above @p type, or @ref no_slot. Iterators go
+         * through the entries in the order of their types, the order of the std::map the
+         * entries were stored in before, which field processing depends on.
+         */
+        size_t next_slot( field_id type ) const;
+        static constexpr size_t no_slot = std::numeric_limits<size_t>::max();
+        void update_displayed_field_type();
 };
 
 #endif
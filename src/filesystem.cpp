@@ -9,6 +9,7 @@
 #include <cstring>
 #include <deque>
 #include <fstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <iterator>
@@ -22,6 +23,8 @@
 #   include "wdirent.h"
 #else
 #   include <dirent.h>
+#   include <fcntl.h>
+#   include <sys/mman.h>
 #   include <unistd.h>
 #endif
 
@@ -125,6 +128,49 @@ bool remove_directory( const std::string &path )
 #endif
 }
 
+mapped_file::mapped_file( const std::string &path )
+{
+#if !defined(_WIN32)
+    const int fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 ) {
+        throw std::runtime_error( "opening " + path + " failed" );
+    }
+    struct stat info;
+    if( fstat( fd, &info ) == 0 && info.st_size > 0 ) {
+        void *const view = mmap( nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( view != MAP_FAILED ) {
+            begin = static_cast<const char *>( view );
+            length = info.st_size;
+            mapped = true;
+        }
+    }
+    close( fd );
+    if( mapped ) {
+        return;
+    }
+#endif
+    // No mapping available, read the whole file instead.
+    std::ifstream fin( path.c_str(), std::ios::binary );
+    if( !fin.is_open() ) {
+        throw std::runtime_error( "opening " + path + " failed" );
+    }
+    contents.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+    if( fin.bad() ) {
+        throw std::runtime_error( "reading " + path + " failed" );
+    }
+    begin = contents.data();
+    length = contents.size();
+}
+
+mapped_file::~mapped_file()
+{
+#if !defined(_WIN32)
+    if( mapped ) {
+        munmap( const_cast<char *>( begin ), length );
+    }
+#endif
+}
+
 const char *cata_files::eol()
 {
 #if defined(_WIN32)
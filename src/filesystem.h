@@ -2,6 +2,7 @@
 #ifndef CATA_FILE_SYSTEM_H
 #define CATA_FILE_SYSTEM_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,35 @@ bool remove_directory( const std::string &path );
 // Rename a file, overriding the target!
 bool rename_file( const std::string &old_path, const std::string &new_path );
 
+/**
+ * A read-only view of a whole file. The file is memory-mapped where the platform supports
+ * it, and read into memory otherwise.
+ */
+class mapped_file
+{
+    public:
+        /** Maps the file at @p path. Throws std::runtime_error if it can't be read. */
+        explicit mapped_file( const std::string &path );
+        ~mapped_file();
+
+        mapped_file( const mapped_file & ) = delete;
+        mapped_file &operator=( const mapped_file & ) = delete;
+
+        const char *data() const {
+            return begin;
+        }
+        size_t size() const {
+            return length;
+        }
+
+    private:
+        const char *begin = nullptr;
+        size_t length = 0;
+        // Only used if the file could not be mapped.
+        std::string contents;
+        bool mapped = false;
+};
+
 namespace cata_files
 {
 const char *eol();
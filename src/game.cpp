@@ -103,6 +103,7 @@
 #include "recipe_dictionary.h"
 #include "rng.h"
 #include "safemode_ui.h"
+#include "save_writer.h"
 #include "scenario.h"
 #include "scent_map.h"
 #include "sdltiles.h"
@@ -1395,6 +1396,7 @@ bool game::do_turn()
         !u.is_dead_state() ) {
         autosave();
     }
+    report_background_save();
 
     weather.update_weather();
     reset_light_level();
@@ -1487,7 +1489,7 @@ bool game::do_turn()
 
     // Process power and fuel consumption for all vehicles, including off-map ones.
     // m.vehmove used to do this, but now it only give them moves instead.
-    for( auto &elem : MAPBUFFER ) {
+    for( auto &elem : MAPBUFFER.get_submaps_with_vehicles() ) {
         tripoint sm_loc = elem.first;
         point sm_topleft = sm_to_ms_copy( sm_loc.x, sm_loc.y );
         point in_reality = m.getlocal( sm_topleft );
@@ -1499,6 +1501,7 @@ bool game::do_turn()
             veh->idle( in_bubble_z && m.inbounds( in_reality ) );
         }
     }
+    prefetch_submaps();
     m.process_fields();
     m.process_active_items();
     m.creature_in_field( u );
@@ -2592,6 +2595,8 @@ bool game::load( const std::string &world )
 void game::load( const save_t &name )
 {
     using namespace std::placeholders;
+    // Files of the last autosave may still be written.
+    get_save_writer().wait();
 
     const std::string worldpath = get_world_base_save_path() + "/";
     const std::string playerpath = worldpath + name.base_path();
@@ -2832,6 +2837,31 @@ bool game::save_player_data()
            ;
 }
 
+bool game::save_in_background()
+{
+    save_writer &writer = get_save_writer();
+    writer.begin_save();
+    const bool saved = save();
+    writer.end_save();
+    return saved;
+}
+
+void game::report_background_save()
+{
+    save_writer::save_stats stats;
+    if( !get_save_writer().take_finished( stats ) ) {
+        return;
+    }
+    dbg( D_INFO ) << "background save: " << stats.files_written << " files written, " <<
+                  stats.files_unchanged << " unchanged, " << stats.files_removed << " removed, " <<
+                  stats.bytes_written << " bytes, gathered in " << stats.snapshot_time.count() <<
+                  " ms, written in " << stats.write_time.count() << " ms";
+    if( !stats.errors.empty() ) {
+        popup( _( "Failed to save the game in the background:\n%s" ),
+               enumerate_as_string( stats.errors, enumeration_conjunction::none ) );
+    }
+}
+
 bool game::save()
 {
     try {
@@ -4127,32 +4157,7 @@ void game::monmove()
 {
     cleanup_dead();
 
-    // Make sure these don't match the first time around.
-    tripoint cached_lev = m.get_abs_sub() + tripoint( 1, 0, 0 );
-
-    // used to force update of the monster factions if a monster has changed its z-level.
-    bool force_mfactions_update = false;
-
-    mfactions monster_factions;
-    const auto &playerfaction = mfaction_str_id( "player" );
     for( monster &critter : all_monsters() ) {
-        // The first time through, and any time the map has been shifted, or a monster changed its z-level
-        // recalculate monster factions.
-        if( cached_lev != m.get_abs_sub() || force_mfactions_update ) {
-            force_mfactions_update = false;
-            // monster::plan() needs to know about all monsters on the same team as the monster.
-            monster_factions.clear();
-            for( monster &critter : all_monsters() ) {
-                if( critter.friendly == 0 ) {
-                    // Only 1 faction per mon at the moment.
-                    monster_factions[ critter.faction ].insert( &critter );
-                } else {
-                    monster_factions[ playerfaction ].insert( &critter );
-                }
-            }
-            cached_lev = m.get_abs_sub();
-        }
-
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && m.impassable( critter.pos() ) && !critter.can_move_to( critter.pos() ) ) {
             dbg( D_ERROR ) << "game:monmove: " << critter.name()
@@ -4186,23 +4191,13 @@ void game::monmove()
             // Controlled critters don't make their own plans
             if( !critter.has_effect( effect_controlled ) ) {
                 // Formulate a path to follow
-                critter.plan( monster_factions );
+                critter.plan();
             }
             critter.move(); // Move one square, possibly hit u
             critter.process_triggers();
             m.creature_in_field( critter );
         }
 
-        // FIX #28679
-        // It is possible that a monster has fallen down a z-level during critter.move() above, if it stepped on a trap.
-        // In this case the monster is deleted during the iteration of this `for` loop in
-        //  game::non_dead_range<monster>::iterator::operator++().
-        // We must make sure that we update the monster_factions so we don't pass a deleted monster later in critter.plan().
-        // Note that this only applies if z-levels are not active.
-        if( !g->m.has_zlevels() && critter.posz() != g->u.posz() ) {
-            force_mfactions_update = true;
-        }
-
         if( !critter.is_dead() &&
             u.has_active_bionic( bionic_id( "bio_alarm" ) ) &&
             u.power_level >= 25 &&
@@ -10417,6 +10412,33 @@ point game::update_map( int &x, int &y )
     return point( shiftx, shifty );
 }
 
+void game::prefetch_submaps()
+{
+    const tripoint abs_pos = m.getabs( u.pos() );
+    point velocity( abs_pos.x - prefetch_last_position.x, abs_pos.y - prefetch_last_position.y );
+    if( prefetch_last_position == tripoint_min || std::abs( velocity.x ) > MAPSIZE_X ||
+        std::abs( velocity.y ) > MAPSIZE_Y ) {
+        // First call or teleported, there is no direction to go by.
+        velocity = point_zero;
+    }
+    prefetch_last_position = abs_pos;
+    if( u.in_vehicle ) {
+        // Vehicles move several tiles per turn, their speed is a better guess than the
+        // distance covered last turn.
+        const vehicle *const veh = veh_pointer_or_null( m.veh_at( u.pos() ) );
+        if( veh != nullptr && veh->velocity != 0 ) {
+            const float tiles = veh->velocity / vehicles::vmiph_per_tile;
+            const double angle = veh->move.dir() * M_PI / 180;
+            velocity = point( std::lround( tiles * cos( angle ) ),
+                              std::lround( tiles * sin( angle ) ) );
+        }
+    }
+    m.prefetch_submaps( u.pos(), velocity );
+    // Decode a few of the quads read so far, so they don't all have to be decoded at once
+    // when the map shifts.
+    MAPBUFFER.install_prefetched( 2 );
+}
+
 void game::update_overmap_seen()
 {
     const tripoint ompos = u.global_omt_location();
@@ -10910,18 +10932,31 @@ void game::init_autosave()
 }
 
 void game::quicksave()
+{
+    quicksave( false );
+}
+
+void game::quicksave( const bool in_background )
 {
     //Don't autosave if the player hasn't done anything since the last autosave/quicksave,
     if( !moves_since_last_save ) {
         return;
     }
-    add_msg( m_info, _( "Saving game, this may take a while" ) );
-    popup_nowait( _( "Saving game, this may take a while" ) );
+    if( in_background ) {
+        add_msg( m_info, _( "Saving game in the background" ) );
+    } else {
+        add_msg( m_info, _( "Saving game, this may take a while" ) );
+        popup_nowait( _( "Saving game, this may take a while" ) );
+    }
 
     time_t now = time( nullptr ); //timestamp for start of saving procedure
 
     //perform save
-    save();
+    if( in_background ) {
+        save_in_background();
+    } else {
+        save();
+    }
     //Now reset counters for autosaving, so we don't immediately autosave after a quicksave or autosave.
     moves_since_last_save = 0;
     last_save_timestamp = now;
@@ -10956,7 +10991,10 @@ void game::autosave()
     if( time( nullptr ) < last_save_timestamp + 60 * get_option<int>( "AUTOSAVE_MINUTES" ) ) {
         return;
     }
-    quicksave();    //Driving checks are handled by quicksave()
+    // Map sharing locks files from the main thread, those saves have to stay synchronous.
+    const bool in_background = get_option<bool>( "AUTOSAVE_BACKGROUND" ) &&
+                               save_writer::available() && !MAP_SHARING::isSharing();
+    quicksave( in_background );    //Driving checks are handled by quicksave()
 }
 
 void intro()
@@ -204,6 +204,13 @@ class game
 
         /** Returns false if saving failed. */
         bool save();
+        /**
+         * Saves the game, writing the files in the background (see @ref save_writer).
+         * Errors while writing are reported by a later @ref report_background_save.
+         */
+        bool save_in_background();
+        /** Reports the outcome of a background save once it has been written. */
+        void report_background_save();
 
         /** Returns a list of currently active character saves. */
         std::vector<std::string> list_active_characters();
@@ -494,6 +501,8 @@ class game
         // Helper to make calling with a player pointer less verbose.
         point update_map( player &p );
         point update_map( int &x, int &y );
+        // Prefetches the submaps the player is heading towards, see map::prefetch_submaps.
+        void prefetch_submaps();
         void update_overmap_seen(); // Update which overmap tiles we can see
 
         void process_artifact( item &it, player &p );
@@ -843,6 +852,7 @@ class game
 
         //  int autosave_timeout();  // If autosave enabled, how long we should wait for user inaction before saving.
         void autosave();         // automatic quicksaves - Performs some checks before calling quicksave()
+        void quicksave( bool in_background );
     public:
         void quicksave();        // Saves the game without quitting
         void disp_NPCs();        // Currently for debug use.  Lists global NPCs.
@@ -929,6 +939,8 @@ class game
         // that has been added to u.view_offset,
         // Don't write to this directly, always use set_driving_view_offset
         point driving_view_offset;
+        // Absolute position of the player at the last prefetch_submaps call.
+        tripoint prefetch_last_position = tripoint_min;
 
         bool debug_pathfinding = false; // show NPC pathfinding on overmap ui
         bool displaying_scent;
@@ -11,11 +11,21 @@
 #include <memory>
 #include <stdexcept>
 
+// MinGW without posix threads lacks std::thread, data files are read one by one there.
+#if !defined(_WIN32) || defined(_MSC_VER)
+#   define CATA_PARALLEL_DATA_LOADING
+#   include <algorithm>
+#   include <condition_variable>
+#   include <mutex>
+#   include <thread>
+#endif
+
 #include "activity_type.h"
 #include "ammo.h"
 #include "anatomy.h"
 #include "behavior.h"
 #include "bionics.h"
+#include "cata_utility.h"
 #include "construction.h"
 #include "crafting_gui.h"
 #include "debug.h"
@@ -28,6 +38,7 @@
 #include "field_type.h"
 #include "flag.h"
 #include "gates.h"
+#include "get_version.h"
 #include "harvest.h"
 #include "item_action.h"
 #include "item_factory.h"
@@ -52,6 +63,7 @@
 #include "overlay_ordering.h"
 #include "overmap_connection.h"
 #include "overmap_location.h"
+#include "path_info.h"
 #include "profession.h"
 #include "recipe_dictionary.h"
 #include "recipe_groups.h"
@@ -77,7 +89,21 @@
 #include "translations.h"
 #include "type_id.h"
 
-DynamicDataLoader::DynamicDataLoader()
+extern bool test_mode;
+
+// FNV-1a, to tell whether the loaded data changed since it was last verified.
+static const uint64_t empty_data_hash = 14695981039346656037ULL;
+
+static uint64_t hash_data( uint64_t hash, const char *data, size_t size )
+{
+    for( size_t i = 0; i < size; i++ ) {
+        hash ^= static_cast<unsigned char>( data[i] );
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+DynamicDataLoader::DynamicDataLoader() : data_hash( empty_data_hash )
 {
     initialize();
 }
@@ -109,8 +135,8 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
         auto it = data.begin();
         for( size_t idx = 0; idx != n; ++idx ) {
             try {
-                std::istringstream str( it->first );
-                JsonIn jsin( str );
+                JsonBuffer buffer( it->first.data(), it->first.size() );
+                JsonIn jsin( buffer );
                 JsonObject jo = jsin.get_object();
                 load_object( jo, it->second );
             } catch( const std::exception &err ) {
@@ -373,6 +399,101 @@ void DynamicDataLoader::initialize()
 #endif
 }
 
+namespace
+{
+/** A data file, mapped into memory and indexed, ready to be loaded. */
+struct prepared_file {
+    std::unique_ptr<mapped_file> contents;
+    std::unique_ptr<JsonBuffer> buffer;
+    uint64_t hash = empty_data_hash;
+    /** Set instead of the above if the file could not be read. */
+    std::exception_ptr error;
+};
+} // namespace
+
+static void prepare_file( const std::string &path, prepared_file &result )
+{
+    try {
+        result.contents.reset( new mapped_file( path ) );
+        result.hash = hash_data( result.hash, result.contents->data(), result.contents->size() );
+        result.buffer.reset( new JsonBuffer( result.contents->data(), result.contents->size() ) );
+    } catch( ... ) {
+        result.error = std::current_exception();
+    }
+}
+
+using prepared_file_loader = std::function<void( const std::string &, prepared_file & )>;
+
+/**
+ * Calls @p load for each of the @p files in order. Reading and indexing the files, which
+ * is most of the work that doesn't depend on data loaded before, happens ahead of that on
+ * all available cores.
+ */
+static void for_each_prepared_file( const std::vector<std::string> &files,
+                                    const prepared_file_loader &load )
+{
+#if defined(CATA_PARALLEL_DATA_LOADING)
+    const size_t num_workers = std::min<size_t>( files.size(),
+                               std::thread::hardware_concurrency() );
+    if( num_workers > 1 ) {
+        std::vector<prepared_file> prepared( files.size() );
+        std::vector<bool> ready( files.size(), false );
+        std::mutex mutex;
+        std::condition_variable file_ready;
+        size_t next = 0;
+
+        const auto work = [&]() {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( next < files.size() ) {
+                const size_t index = next++;
+                lock.unlock();
+                prepare_file( files[index], prepared[index] );
+                lock.lock();
+                ready[index] = true;
+                file_ready.notify_all();
+            }
+        };
+        // Makes the workers stop and waits for them, also if loading a file throws.
+        struct worker_group {
+            std::vector<std::thread> threads;
+            std::mutex &mutex;
+            size_t &next;
+            size_t stop_at;
+            ~worker_group() {
+                {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    next = stop_at;
+                }
+                for( std::thread &t : threads ) {
+                    t.join();
+                }
+            }
+        } workers{ {}, mutex, next, files.size() };
+        for( size_t i = 0; i < num_workers; i++ ) {
+            workers.threads.emplace_back( work );
+        }
+
+        for( size_t i = 0; i < files.size(); i++ ) {
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                file_ready.wait( lock, [&]() {
+                    return ready[i];
+                } );
+            }
+            load( files[i], prepared[i] );
+            // the file is no longer needed
+            prepared[i] = prepared_file();
+        }
+        return;
+    }
+#endif
+    for( const std::string &file : files ) {
+        prepared_file prepared;
+        prepare_file( file, prepared );
+        load( file, prepared );
+    }
+}
+
 void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
         loading_ui &ui )
 {
@@ -393,26 +514,22 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        std::ifstream infile( file.c_str(), std::ifstream::in | std::ifstream::binary );
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                ( std::istreambuf_iterator<char>( infile ) ),
-                std::istreambuf_iterator<char>()
-            )
-        );
+    // iterate over each file, in order, as later files may refer to or override earlier ones
+    for_each_prepared_file( files, [&]( const std::string & file, prepared_file & prepared ) {
+        if( prepared.error ) {
+            std::rethrow_exception( prepared.error );
+        }
+        data_hash = hash_data( data_hash, src.c_str(), src.size() + 1 );
+        data_hash = hash_data( data_hash, reinterpret_cast<const char *>( &prepared.hash ),
+                               sizeof( prepared.hash ) );
         try {
             // parse it
-            JsonIn jsin( iss );
+            JsonIn jsin( *prepared.buffer );
             load_all_from_json( jsin, src, ui, path, file );
         } catch( const JsonError &err ) {
             throw std::runtime_error( file + ": " + err.what() );
         }
-    }
+    } );
 }
 
 void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
@@ -445,6 +562,7 @@ void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src
 void DynamicDataLoader::unload_data()
 {
     finalized = false;
+    data_hash = empty_data_hash;
 
     harvest_list::reset();
     json_flag::reset();
@@ -593,76 +711,98 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
 {
     ui.new_context( _( "Verifying" ) );
 
-    using named_entry = std::pair<std::string, std::function<void()>>;
-    const std::vector<named_entry> entries = {{
-            { _( "Flags" ), &json_flag::check_consistency },
+    struct check_entry {
+        std::string name;
+        std::function<void()> check;
+        // Whether the check only reports problems, without changing the data.
+        bool only_verifies;
+    };
+    const std::vector<check_entry> entries = {{
+            { _( "Flags" ), &json_flag::check_consistency, false },
             {
                 _( "Crafting requirements" ), []()
                 {
                     requirement_data::check_consistency();
-                }
+                }, true
             },
-            { _( "Vitamins" ), &vitamin::check_consistency },
-            { _( "Field types" ), &field_types::check_consistency },
-            { _( "Emissions" ), &emit::check_consistency },
-            { _( "Activities" ), &activity_type::check_consistency },
+            { _( "Vitamins" ), &vitamin::check_consistency, false },
+            { _( "Field types" ), &field_types::check_consistency, false },
+            { _( "Emissions" ), &emit::check_consistency, false },
+            { _( "Activities" ), &activity_type::check_consistency, false },
             {
                 _( "Items" ), []()
                 {
                     item_controller->check_definitions();
-                }
+                }, true
             },
-            { _( "Materials" ), &materials::check },
-            { _( "Engine faults" ), &fault::check_consistency },
-            { _( "Vehicle parts" ), &vpart_info::check },
-            { _( "Mapgen definitions" ), &check_mapgen_definitions },
+            { _( "Materials" ), &materials::check, false },
+            { _( "Engine faults" ), &fault::check_consistency, false },
+            { _( "Vehicle parts" ), &vpart_info::check, false },
+            { _( "Mapgen definitions" ), &check_mapgen_definitions, true },
             {
                 _( "Monster types" ), []()
                 {
                     MonsterGenerator::generator().check_monster_definitions();
-                }
+                }, true
             },
-            { _( "Monster groups" ), &MonsterGroupManager::check_group_definitions },
-            { _( "Furniture and terrain" ), &check_furniture_and_terrain },
-            { _( "Constructions" ), &check_constructions },
-            { _( "Professions" ), &profession::check_definitions },
-            { _( "Scenarios" ), &scenario::check_definitions },
-            { _( "Martial arts" ), &check_martialarts },
-            { _( "Mutations" ), &mutation_branch::check_consistency },
-            { _( "Mutation Categories" ), &mutation_category_trait::check_consistency },
-            { _( "Overmap land use codes" ), &overmap_land_use_codes::check_consistency },
-            { _( "Overmap connections" ), &overmap_connections::check_consistency },
-            { _( "Overmap terrain" ), &overmap_terrains::check_consistency },
-            { _( "Overmap locations" ), &overmap_locations::check_consistency },
-            { _( "Overmap specials" ), &overmap_specials::check_consistency },
-            { _( "Ammunition types" ), &ammunition_type::check_consistency },
-            { _( "Traps" ), &trap::check_consistency },
-            { _( "Bionics" ), &check_bionics },
-            { _( "Gates" ), &gates::check },
-            { _( "NPC classes" ), &npc_class::check_consistency },
-            { _( "Behaviors" ), &behavior::check_consistency },
-            { _( "Mission types" ), &mission_type::check_consistency },
+            { _( "Monster groups" ), &MonsterGroupManager::check_group_definitions, true },
+            { _( "Furniture and terrain" ), &check_furniture_and_terrain, true },
+            { _( "Constructions" ), &check_constructions, false },
+            { _( "Professions" ), &profession::check_definitions, false },
+            { _( "Scenarios" ), &scenario::check_definitions, false },
+            { _( "Martial arts" ), &check_martialarts, false },
+            { _( "Mutations" ), &mutation_branch::check_consistency, true },
+            { _( "Mutation Categories" ), &mutation_category_trait::check_consistency, false },
+            { _( "Overmap land use codes" ), &overmap_land_use_codes::check_consistency, false },
+            { _( "Overmap connections" ), &overmap_connections::check_consistency, false },
+            { _( "Overmap terrain" ), &overmap_terrains::check_consistency, true },
+            { _( "Overmap locations" ), &overmap_locations::check_consistency, false },
+            { _( "Overmap specials" ), &overmap_specials::check_consistency, true },
+            { _( "Ammunition types" ), &ammunition_type::check_consistency, false },
+            { _( "Traps" ), &trap::check_consistency, false },
+            { _( "Bionics" ), &check_bionics, false },
+            { _( "Gates" ), &gates::check, false },
+            { _( "NPC classes" ), &npc_class::check_consistency, false },
+            { _( "Behaviors" ), &behavior::check_consistency, false },
+            { _( "Mission types" ), &mission_type::check_consistency, false },
             {
                 _( "Item actions" ), []()
                 {
                     item_action_generator::generator().check_consistency();
-                }
+                }, false
             },
-            { _( "Harvest lists" ), &harvest_list::check_consistency },
-            { _( "NPC templates" ), &npc_template::check_consistency },
-            { _( "Body parts" ), &body_part_struct::check_consistency },
-            { _( "Anatomies" ), &anatomy::check_consistency },
-            { _( "Spells" ), &spell_type::check_consistency }
+            { _( "Harvest lists" ), &harvest_list::check_consistency, false },
+            { _( "NPC templates" ), &npc_template::check_consistency, false },
+            { _( "Body parts" ), &body_part_struct::check_consistency, false },
+            { _( "Anatomies" ), &anatomy::check_consistency, false },
+            { _( "Spells" ), &spell_type::check_consistency, false }
         }
     };
 
-    for( const named_entry &e : entries ) {
-        ui.add_entry( e.first );
+    const std::string verified = std::to_string( data_hash ) + " " + getVersionString();
+    std::string last_verified;
+    read_from_file_optional( FILENAMES["verified_data"], [&last_verified]( std::istream & fin ) {
+        std::getline( fin, last_verified );
+    } );
+    // Tests and --check-mods always run every check: some checks only report in test mode, and
+    // the verified state can't tell whether the checks themselves changed in a local build.
+    const bool already_verified = !test_mode && last_verified == verified;
+
+    for( const check_entry &e : entries ) {
+        ui.add_entry( e.name );
     }
 
     ui.show();
-    for( const named_entry &e : entries ) {
-        e.second();
+    for( const check_entry &e : entries ) {
+        if( !already_verified || !e.only_verifies ) {
+            e.check();
+        }
         ui.proceed();
     }
+
+    if( !test_mode && !already_verified && !debug_has_error_been_observed() ) {
+        write_to_file( FILENAMES["verified_data"], [&verified]( std::ostream & fout ) {
+            fout << verified << std::endl;
+        }, nullptr );
+    }
 }
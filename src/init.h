@@ -2,6 +2,7 @@
 #ifndef INIT_H
 #define INIT_H
 
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <map>
@@ -65,6 +66,8 @@ class DynamicDataLoader
 
     private:
         bool finalized = false;
+        /** Hash of the contents of all files loaded since the data was last unloaded. */
+        uint64_t data_hash;
 
     protected:
         /**
@@ -107,6 +110,8 @@ class DynamicDataLoader
         /**
          * Check the consistency of all the loaded data.
          * May print a debugmsg if something seems wrong.
+         * Checks that only report problems are skipped if the same data
+         * passed them before, see @ref data_hash.
          * @param ui Finalization status display.
          */
         void check_consistency( loading_ui &ui );
@@ -111,6 +111,22 @@ invlet_favorites::get_invlets_by_id() const
 
 inventory::inventory() = default;
 
+inventory::inventory( const inventory &other ) : visitable<inventory>( other ),
+    assigned_invlet( other.assigned_invlet ), invlet_cache( other.invlet_cache ),
+    items( other.items )
+{
+}
+
+inventory &inventory::operator=( const inventory &rhs )
+{
+    assigned_invlet = rhs.assigned_invlet;
+    invlet_cache = rhs.invlet_cache;
+    items = rhs.items;
+    binned = false;
+    quality_binned = false;
+    return *this;
+}
+
 invslice inventory::slice()
 {
     invslice stacks;
@@ -151,8 +167,8 @@ size_t inventory::size() const
 
 inventory &inventory::operator+= ( const inventory &rhs )
 {
-    for( size_t i = 0; i < rhs.size(); i++ ) {
-        push_back( rhs.const_stack( i ) );
+    for( const std::list<item> &stack : rhs.items ) {
+        push_back( stack );
     }
     return *this;
 }
@@ -197,6 +213,7 @@ inventory inventory::operator+ ( const item &rhs )
 void inventory::unsort()
 {
     binned = false;
+    quality_binned = false;
 }
 
 static bool stack_compare( const std::list<item> &lhs, const std::list<item> &rhs )
@@ -208,6 +225,7 @@ void inventory::clear()
 {
     items.clear();
     binned = false;
+    quality_binned = false;
 }
 
 void inventory::push_back( const std::list<item> &newits )
@@ -254,26 +272,40 @@ char inventory::find_usable_cached_invlet( const std::string &item_type )
 item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, bool should_stack )
 {
     binned = false;
+    quality_binned = false;
 
-    if( should_stack ) {
+    const auto add_to_stack = [&]( std::list<item> &elem ) -> item & {
+        std::list<item>::iterator it_ref = elem.begin();
+        if( it_ref->merge_charges( newit ) ) {
+            return *it_ref;
+        }
+        if( it_ref->invlet == '\0' ) {
+            if( !keep_invlet ) {
+                update_invlet( newit, assign_invlet );
+            }
+            update_cache_with_item( newit );
+            it_ref->invlet = newit.invlet;
+        } else {
+            newit.invlet = it_ref->invlet;
+        }
+        elem.push_back( newit );
+        return elem.back();
+    };
+
+    if( should_stack && stacks_indexed && !( keep_invlet && assign_invlet ) ) {
+        // Only stacks of the same type can take the item, and no other stack has to give up
+        // its invlet, so the other stacks don't need to be looked at.
+        for( std::list<item> *elem : stacks_by_type[newit.typeId()] ) {
+            if( elem->front().stacks_with( newit ) ) {
+                return add_to_stack( *elem );
+            }
+        }
+    } else if( should_stack ) {
         // See if we can't stack this item.
         for( auto &elem : items ) {
             std::list<item>::iterator it_ref = elem.begin();
             if( it_ref->stacks_with( newit ) ) {
-                if( it_ref->merge_charges( newit ) ) {
-                    return *it_ref;
-                }
-                if( it_ref->invlet == '\0' ) {
-                    if( !keep_invlet ) {
-                        update_invlet( newit, assign_invlet );
-                    }
-                    update_cache_with_item( newit );
-                    it_ref->invlet = newit.invlet;
-                } else {
-                    newit.invlet = it_ref->invlet;
-                }
-                elem.push_back( newit );
-                return elem.back();
+                return add_to_stack( elem );
             } else if( keep_invlet && assign_invlet && it_ref->invlet == newit.invlet ) {
                 // If keep_invlet is true, we'll be forcing other items out of their current invlet.
                 assign_empty_invlet( *it_ref, g->u );
@@ -290,6 +322,9 @@ item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, boo
     std::list<item> newstack;
     newstack.push_back( newit );
     items.push_back( newstack );
+    if( stacks_indexed ) {
+        stacks_by_type[newit.typeId()].push_back( &items.back() );
+    }
     return items.back().back();
 }
 
@@ -315,6 +350,7 @@ void inventory::restack( player &p )
     // 3. combine matching stacks
 
     binned = false;
+    quality_binned = false;
     std::list<item> to_restack;
     int idx = 0;
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter, ++idx ) {
@@ -402,6 +438,10 @@ void inventory::form_from_map( map &m, const tripoint &origin, int range, bool a
     }
 
     items.clear();
+    binned = false;
+    quality_binned = false;
+    stacks_by_type.clear();
+    stacks_indexed = true;
     for( const tripoint &p : reachable_pts ) {
         if( m.has_furn( p ) ) {
             const furn_t &f = m.furn( p ).obj();
@@ -565,6 +605,8 @@ void inventory::form_from_map( map &m, const tripoint &origin, int range, bool a
         }
     }
     reachable_pts.clear();
+    stacks_by_type.clear();
+    stacks_indexed = false;
 }
 
 std::list<item> inventory::reduce_stack( const int position, const int quantity )
@@ -574,6 +616,7 @@ std::list<item> inventory::reduce_stack( const int position, const int quantity
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
         if( position == pos ) {
             binned = false;
+            quality_binned = false;
             if( quantity >= static_cast<int>( iter->size() ) || quantity < 0 ) {
                 ret = *iter;
                 items.erase( iter );
@@ -596,6 +639,7 @@ item inventory::remove_item( const item *it )
     }, 1 );
     if( !tmp.empty() ) {
         binned = false;
+        quality_binned = false;
         return tmp.front();
     }
     debugmsg( "Tried to remove a item not in inventory." );
@@ -608,6 +652,7 @@ item inventory::remove_item( const int position )
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
         if( position == pos ) {
             binned = false;
+            quality_binned = false;
             if( iter->size() > 1 ) {
                 std::list<item>::iterator stack_member = iter->begin();
                 char invlet = stack_member->invlet;
@@ -653,6 +698,7 @@ std::list<item> inventory::remove_randomly_by_volume( const units::volume &volum
         }
         if( chosen_stack->empty() ) {
             binned = false;
+            quality_binned = false;
             items.erase( chosen_stack );
         }
     }
@@ -740,6 +786,7 @@ std::list<item> inventory::use_amount( itype_id it, int quantity,
         }
         if( iter->empty() ) {
             binned = false;
+            quality_binned = false;
             iter = items.erase( iter );
         } else if( iter != items.end() ) {
             ++iter;
@@ -1139,6 +1186,35 @@ const itype_bin &inventory::get_binned_items() const
     return binned_items;
 }
 
+const quality_bin &inventory::get_binned_qualities() const
+{
+    if( quality_binned ) {
+        return binned_qualities;
+    }
+
+    binned_qualities.clear();
+    for( const std::list<item> &stack : items ) {
+        const int stack_size = stack.size();
+        stack.front().visit_items( [this, stack_size]( const item * e ) {
+            // An item has the qualities of its contents too.
+            std::set<quality_id> qualities;
+            e->visit_items( [&qualities]( const item * content ) {
+                for( const auto &quality : content->type->qualities ) {
+                    qualities.insert( quality.first );
+                }
+                return VisitResponse::NEXT;
+            } );
+            for( const quality_id &quality : qualities ) {
+                binned_qualities[quality].emplace_back( e, stack_size );
+            }
+            return VisitResponse::NEXT;
+        } );
+    }
+
+    quality_binned = true;
+    return binned_qualities;
+}
+
 void inventory::copy_invlet_of( const inventory &other )
 {
     assigned_invlet = other.assigned_invlet;
@@ -32,6 +32,8 @@ using invslice = std::vector<std::list<item> *>;
 using const_invslice = std::vector<const std::list<item> *>;
 using indexed_invslice = std::vector< std::pair<std::list<item>*, int> >;
 using itype_bin = std::unordered_map< itype_id, std::list<const item *> >;
+/** Items that may have a quality, paired with the size of their stack. */
+using quality_bin = std::unordered_map< quality_id, std::vector<std::pair<const item *, int>> >;
 using invlets_bitset = std::bitset<std::numeric_limits<char>::max()>;
 
 /**
@@ -96,9 +98,10 @@ class inventory : public visitable<inventory>
 
         inventory();
         inventory( inventory && ) = default;
-        inventory( const inventory & ) = default;
+        // The binned items would point into the copied inventory, so they are not copied.
+        inventory( const inventory &other );
         inventory &operator=( inventory && ) = default;
-        inventory &operator=( const inventory & ) = default;
+        inventory &operator=( const inventory &rhs );
 
         inventory &operator+= ( const inventory &rhs );
         inventory &operator+= ( const item &rhs );
@@ -216,6 +219,11 @@ class inventory : public visitable<inventory>
          * May not contain items that wouldn't be visited by @ref visitable methods.
          */
         const itype_bin &get_binned_items() const;
+        /**
+         * Returns the visitable items binned by the qualities they or their contents have.
+         * Only the first item of each stack is included, paired with the size of the stack.
+         */
+        const quality_bin &get_binned_qualities() const;
 
         void update_cache_with_item( item &newit );
 
@@ -227,13 +235,22 @@ class inventory : public visitable<inventory>
 
         invstack items;
 
-        mutable bool binned;
+        mutable bool binned = false;
         /**
          * Items binned by their type.
          * That is, item_bin["carrot"] is a list of pointers to all carrots in inventory.
          * `mutable` because this is a pure cache that doesn't affect the contained items.
          */
         mutable itype_bin binned_items;
+        mutable bool quality_binned = false;
+        mutable quality_bin binned_qualities;
+
+        /**
+         * Stacks indexed by the type of their items. Only used while @ref form_from_map adds
+         * items, so @ref add_item does not have to compare each item with every stack.
+         */
+        std::unordered_map<itype_id, std::vector<std::list<item> *>> stacks_by_type;
+        bool stacks_indexed = false;
 };
 
 #endif
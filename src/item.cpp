@@ -7362,13 +7362,18 @@ bool item::needs_processing() const
            is_artifact() || is_food();
 }
 
-int item::processing_speed() const
+time_point item::next_processing_time() const
 {
-    if( is_corpse() || is_food() || is_food_container() ) {
-        return to_turns<int>( 10_minutes );
+    if( is_food_container() ) {
+        return contents.front().next_processing_time();
     }
-    // Unless otherwise indicated, update every turn.
-    return 1;
+    const time_point now = calendar::turn;
+    // Mirrors the check at the start of process_temperature_rot, including the case of the
+    // time having been set back.
+    if( !has_temperature() || specific_energy <= 0 || last_temp_check > now ) {
+        return now;
+    }
+    return last_temp_check + 10_minutes;
 }
 
 void item::apply_freezerburn()
@@ -7397,7 +7402,7 @@ void item::process_temperature_rot( float insulation, const tripoint &pos,
     }
 
     // process temperature and rot at most once every 100_turns (10 min)
-    // note we're also gated by item::processing_speed
+    // item::next_processing_time relies on this interval
     time_duration smallest_interval = 10_minutes;
     if( now - last_temp_check < smallest_interval && specific_energy > 0 ) {
         return;
@@ -7442,8 +7447,6 @@ void item::process_temperature_rot( float insulation, const tripoint &pos,
     if( now - time > 1_hours ) {
         // This code is for items that were left out of reality bubble for long time
 
-        const auto &wgen = g->weather.get_cur_weather_gen();
-        const auto seed = g->get_seed();
         const auto local = g->m.getlocal( pos );
         auto local_mod = g->new_game ? 0 : g->m.get_temperature( local );
 
@@ -7460,6 +7463,21 @@ void item::process_temperature_rot( float insulation, const tripoint &pos,
             local_mod += 5; // body heat increases inventory temperature
         }
 
+        // Steps more than 2 days ago overwrite the temperature of the steps before them. If rot
+        // can't change either, only the last of them matters, skip straight to it.
+        const bool rot_changes = goes_bad() && !item_tags.count( "FROZEN" ) &&
+                                 ( is_corpse() || get_relative_rot() <= 2.0 );
+        const bool gone = has_rotten_away() || ( is_corpse() && rot > 10_days );
+        if( !rot_changes && !gone ) {
+            // Steps are 1 hour each, the last one more than 2 days ago is step number
+            // ( turns to that point - 1 ) / ( turns per hour ).
+            const int hour = to_turns<int>( 1_hours );
+            const int skipped_hours = ( to_turns<int>( now - 2_days - time ) - 1 ) / hour - 1;
+            if( skipped_hours > 0 ) {
+                time += skipped_hours * 1_hours;
+            }
+        }
+
         // Process the past of this item since the last time it was processed
         while( time < now - 1_hours ) {
             // Get the enviroment temperature
@@ -7469,8 +7487,8 @@ void item::process_temperature_rot( float insulation, const tripoint &pos,
             //Use weather if above ground, use map temp if below
             double env_temperature = 0;
             if( pos.z >= 0 ) {
-                w_point weather = wgen.get_weather( pos, time, seed );
-                env_temperature = weather.temperature + enviroment_mod + local_mod;
+                env_temperature = g->weather.get_weather_temperature( pos, time ) + enviroment_mod +
+                                  local_mod;
             } else {
                 env_temperature = AVERAGE_ANNUAL_TEMPERATURE + enviroment_mod + local_mod;
             }
@@ -1008,9 +1008,19 @@ class item : public visitable<item>
          */
         bool needs_processing() const;
         /**
-         * The rate at which an item should be processed, in number of turns between updates.
-         */
-        int processing_speed() const;
+         * The turn on which processing this item can next have any effect, as long as nothing
+         * else changes it. Food and corpses only change when their temperature and rot are
+         * updated, which happens every 10 minutes. Other items need processing every turn, for
+         * them this is the current turn.
+         *
+         * Active tools, including devices drawing or charging power and items burning fuel,
+         * can't sleep: processing them advances their state by one turn. Their countdown
+         * (item_counter) is decremented, their use actions tick, power draw below one charge
+         * per turn is consumed at random and emitted fields are placed. Temperature and rot
+         * are instead computed from the time since the last check, so only they can be
+         * skipped.
+         */
+        time_point next_processing_time() const;
         /**
          * Process and apply artifact effects. This should be called exactly once each turn, it may
          * modify character stats (like speed, strength, ...), so call it after those have been reset.
@@ -134,9 +134,9 @@ bool JsonObject::empty()
 int JsonObject::verify_position( const std::string &name,
                                  const bool throw_exception )
 {
-    int pos = positions[name]; // initialized to 0 if it doesn't exist
-    if( pos > start ) {
-        return pos;
+    const auto iter = positions.find( name );
+    if( iter != positions.end() ) {
+        return iter->second;
     } else if( throw_exception && !jsin ) {
         throw JsonError( std::string( "member lookup on empty object: " ) + name );
     } else if( throw_exception ) {
@@ -219,8 +219,8 @@ bool JsonObject::get_bool( const std::string &name )
 
 bool JsonObject::get_bool( const std::string &name, const bool fallback )
 {
-    int pos = positions[name];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return fallback;
     }
     jsin->seek( pos );
@@ -236,8 +236,8 @@ int JsonObject::get_int( const std::string &name )
 
 int JsonObject::get_int( const std::string &name, const int fallback )
 {
-    int pos = positions[name];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return fallback;
     }
     jsin->seek( pos );
@@ -253,8 +253,8 @@ double JsonObject::get_float( const std::string &name )
 
 double JsonObject::get_float( const std::string &name, const double fallback )
 {
-    int pos = positions[name];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return fallback;
     }
     jsin->seek( pos );
@@ -270,8 +270,8 @@ std::string JsonObject::get_string( const std::string &name )
 
 std::string JsonObject::get_string( const std::string &name, const std::string &fallback )
 {
-    int pos = positions[name];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return fallback;
     }
     jsin->seek( pos );
@@ -282,8 +282,8 @@ std::string JsonObject::get_string( const std::string &name, const std::string &
 
 JsonArray JsonObject::get_array( const std::string &name )
 {
-    int pos = positions[name];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return JsonArray(); // empty array
     }
     jsin->seek( pos );
@@ -312,8 +312,8 @@ std::vector<std::string> JsonObject::get_string_array( const std::string &name )
 
 JsonObject JsonObject::get_object( const std::string &name )
 {
-    int pos = positions[name];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return JsonObject(); // empty object
     }
     jsin->seek( pos );
@@ -694,12 +694,186 @@ void add_array_to_set( std::set<std::string> &s, JsonObject &json, const std::st
     }
 }
 
+/* class JsonBuffer
+ * JSON text held in memory,
+ * with the extent of every object and array in it.
+ */
+JsonBuffer::memory_streambuf::memory_streambuf( const char *data, size_t size )
+{
+    // The buffer is only ever read from.
+    char *begin = const_cast<char *>( data );
+    setg( begin, begin, begin + size );
+}
+
+JsonBuffer::memory_streambuf::pos_type JsonBuffer::memory_streambuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which )
+{
+    const char *base = dir == std::ios_base::beg ? eback() :
+                       dir == std::ios_base::cur ? gptr() : egptr();
+    return seekpos( pos_type( off_type( base - eback() ) + off ), which );
+}
+
+JsonBuffer::memory_streambuf::pos_type JsonBuffer::memory_streambuf::seekpos(
+    pos_type pos, std::ios_base::openmode which )
+{
+    const off_type off = pos;
+    if( !( which & std::ios_base::in ) || off < 0 || off > egptr() - eback() ) {
+        return pos_type( off_type( -1 ) );
+    }
+    setg( eback(), eback() + off, egptr() );
+    return pos;
+}
+
+JsonBuffer::JsonBuffer( const char *data, size_t size ) : memory( data, size ), input( &memory )
+{
+    index_structure();
+}
+
+int JsonBuffer::end_of_container( int pos ) const
+{
+    const auto iter = std::lower_bound( containers.begin(), containers.end(),
+                                        std::make_pair( pos, 0 ) );
+    if( iter == containers.end() || iter->first != pos ) {
+        return -1;
+    }
+    return iter->second;
+}
+
+void JsonBuffer::index_structure()
+{
+    // Accepts the same text as skipping values with JsonIn does (and nothing else),
+    // so skipping a container by its recorded end always gives the same result.
+    enum class expect {
+        top_value,
+        value,
+        value_or_end,
+        member,
+        member_or_end,
+        separator_or_end,
+    };
+    const char *const begin = memory.begin();
+    const char *const end = memory.end();
+    const char *p = begin;
+    // indices into containers of the objects and arrays not closed yet
+    std::vector<size_t> open;
+    expect state = expect::top_value;
+
+    const auto skip_string = [&]() {
+        for( p++; p != end; p++ ) {
+            if( *p == '\\' ) {
+                if( ++p == end ) {
+                    return false;
+                }
+            } else if( *p == '"' ) {
+                p++;
+                return true;
+            } else if( *p == '\r' || *p == '\n' ) {
+                return false;
+            }
+        }
+        return false;
+    };
+    const auto skip_literal = [&]( const char *literal ) {
+        const size_t len = strlen( literal );
+        if( static_cast<size_t>( end - p ) < len || strncmp( p, literal, len ) != 0 ) {
+            return false;
+        }
+        p += len;
+        return true;
+    };
+    const auto is_number_char = []( char ch ) {
+        return ch == '+' || ch == '-' || ( ch >= '0' && ch <= '9' ) ||
+               ch == 'e' || ch == 'E' || ch == '.';
+    };
+    const auto in_object = [&]() {
+        return begin[containers[open.back()].first] == '{';
+    };
+
+    bool valid = true;
+    while( valid ) {
+        while( p != end && is_whitespace( *p ) ) {
+            p++;
+        }
+        if( state == expect::separator_or_end && open.empty() ) {
+            state = expect::top_value;
+        }
+        if( p == end ) {
+            valid = state == expect::top_value;
+            break;
+        }
+        const char ch = *p;
+        if( ( ch == ']' && state == expect::value_or_end ) ||
+            ( ch == '}' && state == expect::member_or_end ) ||
+            ( state == expect::separator_or_end && ch == ( in_object() ? '}' : ']' ) ) ) {
+            p++;
+            containers[open.back()].second = static_cast<int>( p - begin );
+            open.pop_back();
+            state = expect::separator_or_end;
+            continue;
+        }
+        switch( state ) {
+            case expect::top_value:
+            case expect::value:
+            case expect::value_or_end:
+                state = expect::separator_or_end;
+                if( ch == '{' || ch == '[' ) {
+                    open.push_back( containers.size() );
+                    containers.emplace_back( static_cast<int>( p - begin ), -1 );
+                    state = ch == '{' ? expect::member_or_end : expect::value_or_end;
+                    p++;
+                } else if( ch == '"' ) {
+                    valid = skip_string();
+                } else if( ch == '-' || ( ch >= '0' && ch <= '9' ) ) {
+                    while( p != end && is_number_char( *p ) ) {
+                        p++;
+                    }
+                } else if( ch == 't' ) {
+                    valid = skip_literal( "true" );
+                } else if( ch == 'f' ) {
+                    valid = skip_literal( "false" );
+                } else if( ch == 'n' ) {
+                    valid = skip_literal( "null" );
+                } else {
+                    valid = false;
+                }
+                break;
+            case expect::member:
+            case expect::member_or_end:
+                valid = ch == '"' && skip_string();
+                while( p != end && is_whitespace( *p ) ) {
+                    p++;
+                }
+                valid = valid && p != end && *p == ':';
+                if( valid ) {
+                    p++;
+                }
+                state = expect::value;
+                break;
+            case expect::separator_or_end:
+                valid = ch == ',';
+                p++;
+                state = in_object() ? expect::member : expect::value;
+                break;
+        }
+    }
+    if( !valid ) {
+        // JsonIn reports the error once it gets there.
+        containers.clear();
+    }
+}
+
 int JsonIn::tell()
 {
+    if( buffer && stream->good() ) {
+        return buffer->offset( buffer->cursor() );
+    }
     return stream->tellg();
 }
 char JsonIn::peek()
 {
+    if( buffer && stream->good() && buffer->cursor() != buffer->end() ) {
+        return *buffer->cursor();
+    }
     return static_cast<char>( stream->peek() );
 }
 bool JsonIn::good()
@@ -716,6 +890,18 @@ void JsonIn::seek( int pos )
 
 void JsonIn::eat_whitespace()
 {
+    if( buffer && stream->good() ) {
+        const char *p = buffer->cursor();
+        while( p != buffer->end() && is_whitespace( *p ) ) {
+            p++;
+        }
+        buffer->move_to( p );
+        if( p == buffer->end() ) {
+            // sets eof, just like reading to the end of a stream does
+            stream->peek();
+        }
+        return;
+    }
     while( is_whitespace( peek() ) ) {
         stream->get();
     }
@@ -802,6 +988,22 @@ void JsonIn::skip_string()
         err << "expecting string but found '" << ch << "'";
         error( err.str(), -1 );
     }
+    if( buffer && stream->good() ) {
+        for( const char *p = buffer->cursor(); p != buffer->end(); p++ ) {
+            if( *p == '\\' ) {
+                if( ++p == buffer->end() ) {
+                    break;
+                }
+            } else if( *p == '"' ) {
+                buffer->move_to( p + 1 );
+                end_value();
+                return;
+            } else if( *p == '\r' || *p == '\n' ) {
+                // reported below
+                break;
+            }
+        }
+    }
     while( stream->good() ) {
         stream->get( ch );
         if( ch == '\\' ) {
@@ -848,8 +1050,29 @@ void JsonIn::skip_value()
     // skip_* end value automatically
 }
 
+bool JsonIn::skip_container( const char open )
+{
+    if( !buffer || !stream->good() ) {
+        return false;
+    }
+    eat_whitespace();
+    if( peek() != open ) {
+        return false;
+    }
+    const int end = buffer->end_of_container( tell() );
+    if( end < 0 ) {
+        return false;
+    }
+    seek( end );
+    end_value();
+    return true;
+}
+
 void JsonIn::skip_object()
 {
+    if( skip_container( '{' ) ) {
+        return;
+    }
     start_object();
     while( !end_object() ) {
         skip_member();
@@ -859,6 +1082,9 @@ void JsonIn::skip_object()
 
 void JsonIn::skip_array()
 {
+    if( skip_container( '[' ) ) {
+        return;
+    }
     start_array();
     while( !end_array() ) {
         skip_value();
@@ -943,6 +1169,19 @@ std::string JsonIn::get_string()
         err << "expecting string but got '" << ch << "'";
         error( err.str(), -1 );
     }
+    if( buffer && stream->good() ) {
+        // Strings without escapes are copied in one go.
+        for( const char *p = buffer->cursor(); p != buffer->end(); p++ ) {
+            if( *p == '"' ) {
+                s.assign( buffer->cursor(), p );
+                buffer->move_to( p + 1 );
+                end_value();
+                return s;
+            } else if( *p == '\\' || static_cast<unsigned char>( *p ) < 0x20 ) {
+                break;
+            }
+        }
+    }
     // add chars to the string, one at a time, converting:
     // \", \\, \/, \b, \f, \n, \r, \t and \uxxxx according to JSON spec.
     while( stream->good() ) {
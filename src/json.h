@@ -12,13 +12,16 @@
 #include <map>
 #include <set>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
 
 #include "colony.h"
 
 /* Cataclysm-DDA homegrown JSON tools
  * copyright CC-BY-SA-3.0 2013 CleverRaven
  *
- * Consists of six JSON manipulation tools:
+ * Consists of seven JSON manipulation tools:
+ * JsonBuffer - fast in-memory input for JsonIn
  * JsonIn - for low-level parsing of an input JSON stream
  * JsonOut - for outputting JSON
  * JsonObject - convenience-wrapper for reading JSON objects from a JsonIn
@@ -85,6 +88,92 @@ inline E string_to_enum_look_up( const C &container, const std::string &data )
 /*@}*/
 } // namespace io
 
+/* JsonBuffer
+ * ==========
+ *
+ * The JsonBuffer class provides JsonIn with input from a block of memory,
+ * such as a whole file read or memory-mapped at once.
+ *
+ * Reading from memory lets JsonIn look at the characters directly,
+ * instead of going through the std::istream interface for each one of them,
+ * and makes seeking, which JsonObject and JsonArray do for every value they return, free.
+ *
+ * When the buffer is created, a single pass over the text checks its syntax
+ * and records where each object and array ends.
+ * JsonIn uses this index to skip values without parsing them again,
+ * so indexing the members of a JsonObject costs one step per member,
+ * no matter how much data the members hold.
+ * If the text is not valid JSON, the index is discarded
+ * and errors are reported by JsonIn exactly as for any other stream.
+ *
+ *     mapped_file file( path );
+ *     JsonBuffer buffer( file.data(), file.size() );
+ *     JsonIn jsin( buffer );
+ *
+ * The memory must stay valid and unchanged as long as the buffer is in use.
+ */
+class JsonBuffer
+{
+    public:
+        JsonBuffer( const char *data, size_t size );
+        JsonBuffer( const JsonBuffer & ) = delete;
+        JsonBuffer &operator=( const JsonBuffer & ) = delete;
+
+        std::istream &stream() {
+            return input;
+        }
+
+        // direct access to the text for JsonIn
+        const char *cursor() const {
+            return memory.cursor();
+        }
+        const char *end() const {
+            return memory.end();
+        }
+        int offset( const char *pos ) const {
+            return static_cast<int>( pos - memory.begin() );
+        }
+        void move_to( const char *pos ) {
+            memory.move_to( pos );
+        }
+
+        /**
+         * Offset just behind the object or array that starts at @p pos,
+         * or -1 if the structure is unknown (no value starts there, or the text is invalid).
+         */
+        int end_of_container( int pos ) const;
+
+    private:
+        class memory_streambuf : public std::streambuf
+        {
+            public:
+                memory_streambuf( const char *data, size_t size );
+                const char *begin() const {
+                    return eback();
+                }
+                const char *cursor() const {
+                    return gptr();
+                }
+                const char *end() const {
+                    return egptr();
+                }
+                void move_to( const char *pos ) {
+                    setg( eback(), const_cast<char *>( pos ), egptr() );
+                }
+            protected:
+                pos_type seekoff( off_type off, std::ios_base::seekdir dir,
+                                  std::ios_base::openmode which ) override;
+                pos_type seekpos( pos_type pos, std::ios_base::openmode which ) override;
+        };
+
+        memory_streambuf memory;
+        std::istream input;
+        // (start, end) offsets of every object and array, sorted by start
+        std::vector<std::pair<int, int>> containers;
+
+        void index_structure();
+};
+
 /* JsonIn
  * ======
  *
@@ -169,14 +258,18 @@ class JsonIn
 {
     private:
         std::istream *stream;
+        // only set when reading from memory, see JsonBuffer
+        JsonBuffer *buffer = nullptr;
         bool ate_separator = false;
 
         void skip_separator();
         void skip_pair_separator();
         void end_value();
+        bool skip_container( char open );
 
     public:
         JsonIn( std::istream &s ) : stream( &s ) {}
+        JsonIn( JsonBuffer &b ) : stream( &b.stream() ), buffer( &b ) {}
         JsonIn( const JsonIn & ) = delete;
         JsonIn &operator=( const JsonIn & ) = delete;
 
@@ -680,7 +773,7 @@ class JsonOut
 class JsonObject
 {
     private:
-        std::map<std::string, int> positions;
+        std::unordered_map<std::string, int> positions;
         int start;
         int end;
         bool final_separator;
@@ -767,8 +860,8 @@ class JsonObject
         // return true if the value was set, false otherwise.
         // return false if the member is not found.
         template <typename T> bool read( const std::string &name, T &t ) {
-            int pos = positions[name];
-            if( pos <= start ) {
+            int pos = verify_position( name, false );
+            if( !pos ) {
                 return false;
             }
             jsin->seek( pos );
@@ -968,8 +1061,8 @@ template <typename T>
 std::set<T> JsonObject::get_tags( const std::string &name )
 {
     std::set<T> res;
-    int pos = positions[ name ];
-    if( pos <= start ) {
+    int pos = verify_position( name, false );
+    if( !pos ) {
         return res;
     }
     jsin->seek( pos );
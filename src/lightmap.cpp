@@ -1,12 +1,15 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
+#include <bitset>
 #include <cstdint>
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
 #include <list>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -33,6 +36,7 @@
 #include "optional.h"
 #include "player.h"
 #include "string_formatter.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "type_id.h"
 
@@ -85,20 +89,34 @@ bool map::build_transparency_cache( const int zlev )
     auto &transparency_cache = map_cache.transparency_cache;
     auto &outside_cache = map_cache.outside_cache;
 
-    if( !map_cache.transparency_cache_dirty ) {
+    auto &dirty = map_cache.transparency_cache_dirty;
+
+    if( dirty.none() ) {
         return false;
     }
 
     // Default to just barely not transparent.
-    std::uninitialized_fill_n(
-        &transparency_cache[0][0], MAPSIZE_X * MAPSIZE_Y,
-        static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
+    const bool whole_level = dirty.all();
+    if( whole_level ) {
+        std::uninitialized_fill_n(
+            &transparency_cache[0][0], MAPSIZE_X * MAPSIZE_Y,
+            static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
+    }
 
     const float sight_penalty = weather::sight_penalty( g->weather.weather );
 
-    // Traverse the submaps in order
+    // Traverse the submaps in order, only the dirty ones are recalculated
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !dirty[smx + smy * MAPSIZE] ) {
+                continue;
+            }
+            if( !whole_level ) {
+                for( int sx = 0; sx < SEEX; ++sx ) {
+                    std::fill_n( &transparency_cache[sx + smx * SEEX][smy * SEEY], SEEY,
+                                 static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
+                }
+            }
             const auto cur_submap = get_submap_at_grid( {smx, smy, zlev} );
 
             float zero_value = LIGHT_TRANSPARENCY_OPEN_AIR;
@@ -122,7 +140,7 @@ bool map::build_transparency_cache( const int zlev )
                         break;
                     }
 
-                    if( outside_cache[x][y] ) {
+                    if( outside_cache[level_cache::tile_offset( x, y )] ) {
                         // FIXME: Places inside vehicles haven't been marked as
                         // inside yet so this is incorrectly penalising for
                         // weather in vehicles.
@@ -173,7 +191,8 @@ bool map::build_transparency_cache( const int zlev )
             }
         }
     }
-    map_cache.transparency_cache_dirty = false;
+    map_cache.static_light_dirty |= dirty;
+    dirty.reset();
     return true;
 }
 
@@ -213,7 +232,7 @@ void map::build_sunlight_cache( int zlev )
         const auto &outside_cache = map_cache.outside_cache;
         for( int x = 0; x < MAPSIZE_X; x++ ) {
             for( int y = 0; y < MAPSIZE_Y; y++ ) {
-                if( outside_cache[x][y] ) {
+                if( outside_cache[level_cache::tile_offset( x, y )] ) {
                     lm[x][y].fill( outside_light_level );
                 } else {
                     lm[x][y].fill( inside_light_level );
@@ -254,14 +273,15 @@ void map::build_sunlight_cache( int zlev )
                 prev_transparency = prev_transparency_cache[ prev_x ][ prev_y ];
                 // This is pretty gross, this cancels out the per-tile transparency effect
                 // derived from weather.
-                if( outside_cache[x][y] ) {
+                if( outside_cache[level_cache::tile_offset( x, y )] ) {
                     prev_transparency /= sight_penalty;
                 }
             }
             // The formula to apply transparency to the light rays doesn't handle full opacity,
             // so handle that seperately.
             if( prev_transparency > LIGHT_TRANSPARENCY_SOLID &&
-                !prev_floor_cache[x][y] && prev_light.max() > 0.0 && outside_cache[x][y] ) {
+                !prev_floor_cache[x][y] && prev_light.max() > 0.0 &&
+                outside_cache[level_cache::tile_offset( x, y )] ) {
                 lm[x][y].fill( std::max( inside_light_level,
                                          prev_light.max() * static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR )
                                          / prev_transparency ) );
@@ -327,12 +347,14 @@ void map::generate_lightmap( const int zlev )
                     const int y = sy + smy * SEEY;
                     const tripoint p( x, y, zlev );
                     // Project light into any openings into buildings.
-                    if( !outside_cache[p.x][p.y] ) {
+                    if( !outside_cache[level_cache::tile_offset( p.x, p.y )] ) {
                         // Apply light sources for external/internal divide
                         for( int i = 0; i < 4; ++i ) {
                             if( generic_inbounds( { p.x + dir_x[i], p.y + dir_y[i] },
                                                   lightmap_boundaries, lightmap_clearance
-                                                ) && outside_cache[p.x + dir_x[i]][p.y + dir_y[i]]
+                                                ) &&
+                                outside_cache[level_cache::tile_offset( p.x + dir_x[i],
+                                                                        p.y + dir_y[i] )]
                               ) {
                                 if( light_transparency( p ) > LIGHT_TRANSPARENCY_SOLID ) {
                                     update_light_quadrants(
@@ -420,6 +442,9 @@ void map::generate_lightmap( const int zlev )
         }
     }
 
+    // Everything buffered so far is stationary and usually the same as on the previous turn
+    apply_static_light_sources( zlev );
+
     for( monster &critter : g->all_monsters() ) {
         if( critter.is_hallucination() ) {
             continue;
@@ -515,11 +540,15 @@ void map::generate_lightmap( const int zlev )
     */
     const tripoint cache_start( 0, 0, zlev );
     const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
+    const auto &static_sources = static_lights->sources;
+    std::vector<std::pair<tripoint, float>> sources;
     for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x][p.y] > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x][p.y] );
+        // Stationary sources were already applied, unless a brighter one was added since
+        if( light_source_buffer[p.x][p.y] > static_sources[p.x][p.y] ) {
+            sources.emplace_back( p, light_source_buffer[p.x][p.y] );
         }
     }
+    apply_light_sources( sources, lm, sm );
 
     if( g->u.has_active_bionic( bionic_id( "bio_night" ) ) ) {
         for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
@@ -530,6 +559,80 @@ void map::generate_lightmap( const int zlev )
     }
 }
 
+// Radius of castLight
+static constexpr int max_light_reach = 60;
+
+/**
+ * Whether the light of any of @p sources can reach a submap set in @p submaps.
+ * Light can't go further than luminance / LIGHT_AMBIENT_LOW nor the shadowcasting radius.
+ */
+static bool light_reaches( const float ( &sources )[MAPSIZE_X][MAPSIZE_Y],
+                           const std::bitset<MAPSIZE *MAPSIZE> &submaps )
+{
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( sources[x][y] <= 0.0f ) {
+                continue;
+            }
+            const int reach = std::min( max_light_reach,
+                                        static_cast<int>( sources[x][y] / LIGHT_AMBIENT_LOW ) ) + 1;
+            const int min_smx = std::max( x - reach, 0 ) / SEEX;
+            const int max_smx = std::min( x + reach, MAPSIZE_X - 1 ) / SEEX;
+            const int min_smy = std::max( y - reach, 0 ) / SEEY;
+            const int max_smy = std::min( y + reach, MAPSIZE_Y - 1 ) / SEEY;
+            for( int smx = min_smx; smx <= max_smx; smx++ ) {
+                for( int smy = min_smy; smy <= max_smy; smy++ ) {
+                    if( submaps[smx + smy * MAPSIZE] ) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void map::apply_static_light_sources( const int zlev )
+{
+    auto &map_cache = get_cache( zlev );
+    const auto &light_source_buffer = map_cache.light_source_buffer;
+    if( !static_lights ) {
+        static_lights = std::make_unique<static_light_cache>();
+    }
+    static_light_cache &cache = *static_lights;
+
+    const tripoint origin( abs_sub.x, abs_sub.y, zlev );
+    const bool sources_changed = !cache.valid || cache.origin != origin ||
+                                 std::memcmp( cache.sources, light_source_buffer,
+                                              sizeof( cache.sources ) ) != 0;
+    if( sources_changed || light_reaches( cache.sources, map_cache.static_light_dirty ) ) {
+        std::memcpy( cache.sources, light_source_buffer, sizeof( cache.sources ) );
+        std::memset( cache.lm, 0, sizeof( cache.lm ) );
+        std::memset( cache.sm, 0, sizeof( cache.sm ) );
+        std::vector<std::pair<tripoint, float>> sources;
+        for( int x = 0; x < LIGHTMAP_CACHE_X; x++ ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; y++ ) {
+                if( cache.sources[x][y] > 0.0 ) {
+                    sources.emplace_back( tripoint( x, y, zlev ), cache.sources[x][y] );
+                }
+            }
+        }
+        apply_light_sources( sources, cache.lm, cache.sm );
+        cache.origin = origin;
+        cache.valid = true;
+    }
+    map_cache.static_light_dirty.reset();
+
+    auto &lm = map_cache.lm;
+    auto &sm = map_cache.sm;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            lm[x][y] = elementwise_max( lm[x][y], cache.lm[x][y] );
+            sm[x][y] = std::max( sm[x][y], cache.sm[x][y] );
+        }
+    }
+}
+
 void map::add_light_source( const tripoint &p, float luminance )
 {
     auto &light_source_buffer = get_cache( p.z ).light_source_buffer;
@@ -729,6 +832,46 @@ bool map::pl_line_of_sight( const tripoint &t, const int max_range ) const
            map_cache.camera_cache[t.x][t.y] > 0.0f;
 }
 
+thread_pool *shadowcasting_pool()
+{
+    if( !parallel_shadowcasting ) {
+        return nullptr;
+    }
+    static thread_pool pool( thread_pool::hardware_threads() - 1 );
+    return &pool;
+}
+
+// Whether the octants of castLightAll and cast_zlight may be cast in parallel. They only
+// meet in the tiles they share, where the output is updated with a plain maximum for these
+// types, so the result does not depend on the order. fragment_cloud is only partially ordered.
+template<typename Out>
+struct parallel_octants : std::false_type {};
+template<>
+struct parallel_octants<float> : std::true_type {};
+template<>
+struct parallel_octants<four_quadrants> : std::true_type {};
+
+/**
+ * Calls @p cast_octant for the octants 0-7 (in the order castLightAll and cast_zlight list
+ * them) on the threads of @p pool. Every octant covers one axis and one diagonal, the octants
+ * of each group below cover different ones, so they don't touch any tile in common and
+ * need no synchronization.
+ */
+template<typename F>
+static void cast_octants_in_parallel( thread_pool &pool, const F &cast_octant )
+{
+    static constexpr std::array<std::array<int, 4>, 2> octant_groups = {{
+            {{ 0, 3, 5, 6 }},
+            {{ 1, 2, 4, 7 }}
+        }
+    };
+    for( const std::array<int, 4> &group : octant_groups ) {
+        pool.run( group.size(), [&]( const int i ) {
+            cast_octant( group[i] );
+        } );
+    }
+}
+
 // For a direction vector defined by x, y, return the quadrant that's the
 // source of that direction.  Assumes x != 0 && y != 0
 static constexpr quadrant quadrant_from_x_y( int x, int y )
@@ -957,47 +1100,93 @@ void cast_zlight(
     const std::array<const bool ( * )[MAPSIZE_X][MAPSIZE_Y], OVERMAP_LAYERS> &floor_caches,
     const tripoint &origin, const int offset_distance, const T numerator )
 {
-    // Down
-    cast_zlight_segment < 0, 1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < 1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, 1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < 1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+    // Casts the octant downwards if zz is -1, upwards if it is 1.
+    const auto cast_octant = [&]( const int octant, const int zz ) {
+        switch( octant * 3 + zz ) {
+            case 0 * 3 - 1:
+                cast_zlight_segment < 0, 1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 1 * 3 - 1:
+                cast_zlight_segment < 1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 2 * 3 - 1:
+                cast_zlight_segment < 0, -1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 3 * 3 - 1:
+                cast_zlight_segment < -1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 4 * 3 - 1:
+                cast_zlight_segment < 0, 1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 5 * 3 - 1:
+                cast_zlight_segment < 1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 6 * 3 - 1:
+                cast_zlight_segment < 0, -1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 7 * 3 - 1:
+                cast_zlight_segment < -1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 0 * 3 + 1:
+                cast_zlight_segment<0, 1, 0, 1, 0, 0, 1, T, calc, check, accumulate>(
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 1 * 3 + 1:
+                cast_zlight_segment<1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate>(
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 2 * 3 + 1:
+                cast_zlight_segment < 0, -1, 0, 1, 0, 0, 1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 3 * 3 + 1:
+                cast_zlight_segment < -1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 4 * 3 + 1:
+                cast_zlight_segment < 0, 1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 5 * 3 + 1:
+                cast_zlight_segment < 1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 6 * 3 + 1:
+                cast_zlight_segment < 0, -1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+            case 7 * 3 + 1:
+                cast_zlight_segment < -1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
+                    output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+                break;
+        }
+    };
 
+    thread_pool *const pool = parallel_octants<T>::value ? shadowcasting_pool() : nullptr;
+    if( pool != nullptr ) {
+        // Both segments of an octant write to the z-level of the origin, so they run in order.
+        cast_octants_in_parallel( *pool, [&]( const int octant ) {
+            cast_octant( octant, -1 );
+            cast_octant( octant, 1 );
+        } );
+        return;
+    }
+    // Down
+    for( int octant = 0; octant < 8; octant++ ) {
+        cast_octant( octant, -1 );
+    }
     // Up
-    cast_zlight_segment<0, 1, 0, 1, 0, 0, 1, T, calc, check, accumulate>(
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment<1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate>(
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, 1, 0, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, 1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < 1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+    for( int octant = 0; octant < 8; octant++ ) {
+        cast_octant( octant, 1 );
+    }
 }
 
 // I can't figure out how to make implicit instantiation work when the parameters of
@@ -1121,6 +1310,209 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
     }
 }
 
+// Largest radius castLight_sight has tables for, which is the radius of castLight itself.
+static constexpr int sight_table_radius = 60;
+
+/**
+ * The per-tile values castLight derives from the position of a tile in its octant, for the
+ * tile `delta.x == -col` of the row `delta.y == -row`. They are computed with the same
+ * expressions castLight uses, so the table-driven kernel makes exactly the same decisions.
+ */
+struct octant_tables {
+    float trailing_edge[sight_table_radius + 1][sight_table_radius + 1];
+    float leading_edge[sight_table_radius + 1][sight_table_radius + 1];
+    // rl_dist from the origin, with square distance (0) and with trig distance (1).
+    int distance[2][sight_table_radius + 1][sight_table_radius + 1];
+
+    octant_tables() {
+        static constexpr tripoint origin( 0, 0, 0 );
+        for( int row = 0; row <= sight_table_radius; row++ ) {
+            for( int col = 0; col <= sight_table_radius; col++ ) {
+                const tripoint delta( -col, -row, 0 );
+                trailing_edge[row][col] = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
+                leading_edge[row][col] = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+                distance[0][row][col] = square_dist( origin, delta );
+                distance[1][row][col] = trig_dist( origin, delta );
+            }
+        }
+    }
+};
+
+static const octant_tables &get_octant_tables()
+{
+    static const octant_tables tables;
+    return tables;
+}
+
+/**
+ * Narrows [@p min_dx, @p max_dx] to the values of delta.x for which the coordinate
+ * `base + delta.x * step` lies in [0, @p size).
+ */
+template<int step>
+static inline void clip_row( const int base, const int size, int &min_dx, int &max_dx )
+{
+    if( step == 0 ) {
+        if( base < 0 || base >= size ) {
+            max_dx = min_dx - 1;
+        }
+    } else if( step > 0 ) {
+        min_dx = std::max( min_dx, -base );
+        max_dx = std::min( max_dx, size - 1 - base );
+    } else {
+        min_dx = std::max( min_dx, base - ( size - 1 ) );
+        max_dx = std::min( max_dx, base );
+    }
+}
+
+/**
+ * castLight for the sight kernels (sight_calc, sight_check, accumulate_transparency).
+ *
+ * Instead of handling every tile on its own, it clips each row to the map and to the end
+ * slope once, computes the intensities of the whole row up front (sight_calc only depends
+ * on the distance, so a row needs one exp with square distance), and updates each run of
+ * equally transparent tiles in a tight loop that only does the max. The runs are contiguous
+ * in memory for the octants that walk along y. Slopes and distances come from octant_tables.
+ *
+ * The result is the same as that of the generic castLight.
+ */
+template<int xx, int xy, int yx, int yy, typename Out,
+         void( *update_output )( Out &, const float &, quadrant )>
+static void castLight_sight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
+                             const float ( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                             const int offsetX, const int offsetY, const int offsetDistance,
+                             const float numerator, const int row, float start, const float end,
+                             float cumulative_transparency )
+{
+    constexpr quadrant quad = quadrant_from_x_y( -xx - xy, -yx - yy );
+    if( start < end ) {
+        return;
+    }
+    const octant_tables &tables = get_octant_tables();
+    const auto &distances = tables.distance[trigdist ? 1 : 0];
+    const int radius = sight_table_radius - offsetDistance;
+    float newStart = 0.0f;
+    float intensities[sight_table_radius + 1];
+    for( int distance = row; distance <= radius; distance++ ) {
+        const float *const trailing_edges = tables.trailing_edge[distance];
+        const float *const leading_edges = tables.leading_edge[distance];
+        const int *const row_distances = distances[distance];
+        const int row_x = offsetX - distance * xy;
+        const int row_y = offsetY - distance * yy;
+        const auto tile_output = [&]( const int dx ) -> Out & {
+            return output_cache[row_x + dx * xx][row_y + dx * yx];
+        };
+        const auto tile_input = [&]( const int dx ) {
+            return input_array[row_x + dx * xx][row_y + dx * yx];
+        };
+
+        // The first tile whose leading edge is not past start, as in castLight.
+        const float away = start - ( -distance + 0.5f ) / ( -distance - 0.5f );
+        int min_dx = -distance + std::max( static_cast<int>( ceil( away * ( -distance - 0.5f ) ) ),
+                                           0 );
+        int max_dx = 0;
+        clip_row<xx>( row_x, MAPSIZE_X, min_dx, max_dx );
+        clip_row<yx>( row_y, MAPSIZE_Y, min_dx, max_dx );
+        // Trailing edges shrink towards the diagonal, so the row ends at the first tile
+        // whose trailing edge is past end.
+        int stop = min_dx;
+        while( stop <= max_dx && !( end > trailing_edges[-stop] ) ) {
+            stop++;
+        }
+        if( stop == min_dx ) {
+            // No tile of this row is lit, the same as an opaque row.
+            break;
+        }
+
+        int last_dist = -1;
+        float last_intensity = 0.0f;
+        for( int dx = min_dx; dx < stop; dx++ ) {
+            const int dist = row_distances[-dx] + offsetDistance;
+            if( dist != last_dist ) {
+                last_dist = dist;
+                last_intensity = sight_calc( numerator, cumulative_transparency, dist );
+            }
+            intensities[dx - min_dx] = last_intensity;
+        }
+
+        float current_transparency = tile_input( min_dx );
+        for( int dx = min_dx; dx < stop; ) {
+            const float new_transparency = tile_input( dx );
+            const quadrant run_quadrant = sight_check( new_transparency, 0.0f ) ?
+                                          quadrant::default_ : quad;
+            if( new_transparency != current_transparency ) {
+                const bool was_transparent = sight_check( current_transparency, 0.0f );
+                // Only cast recursively if previous span was not opaque.
+                if( was_transparent ) {
+                    castLight_sight<xx, xy, yx, yy, Out, update_output>(
+                        output_cache, input_array, offsetX, offsetY, offsetDistance,
+                        numerator, distance + 1, start, trailing_edges[-dx],
+                        accumulate_transparency( cumulative_transparency, current_transparency,
+                                                 distance ) );
+                }
+                start = was_transparent ? trailing_edges[-dx] : newStart;
+                if( start < end ) {
+                    update_output( tile_output( dx ), intensities[dx - min_dx], run_quadrant );
+                    return;
+                }
+                current_transparency = new_transparency;
+            }
+            int run_end = dx + 1;
+            while( run_end < stop && tile_input( run_end ) == new_transparency ) {
+                run_end++;
+            }
+            for( ; dx < run_end; dx++ ) {
+                update_output( tile_output( dx ), intensities[dx - min_dx], run_quadrant );
+            }
+            newStart = leading_edges[-( run_end - 1 )];
+        }
+        if( !sight_check( current_transparency, 0.0f ) ) {
+            // If we reach the end of the span with terrain being opaque, we don't iterate further.
+            break;
+        }
+        // Cumulative average of the transparency values encountered.
+        cumulative_transparency = accumulate_transparency( cumulative_transparency,
+                                  current_transparency, distance );
+    }
+}
+
+bool shadowcasting_sight_tables = true;
+
+// Casts one octant for castLightAll, with castLight_sight where it applies.
+template<int xx, int xy, int yx, int yy, typename T, typename Out,
+         T( *calc )( const T &, const T &, const int & ),
+         bool( *check )( const T &, const T & ),
+         void( *update_output )( Out &, const T &, quadrant ),
+         T( *accumulate )( const T &, const T &, const int & )>
+struct octant_caster {
+    static void cast( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
+                      const T( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                      const int offsetX, const int offsetY, const int offsetDistance,
+                      const T numerator ) {
+        castLight<xx, xy, yx, yy, T, Out, calc, check, update_output, accumulate>(
+            output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+    }
+};
+
+template<int xx, int xy, int yx, int yy, typename Out,
+         void( *update_output )( Out &, const float &, quadrant )>
+struct octant_caster<xx, xy, yx, yy, float, Out, sight_calc, sight_check, update_output,
+           accumulate_transparency> {
+    static void cast( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
+                      const float ( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                      const int offsetX, const int offsetY, const int offsetDistance,
+                      const float numerator ) {
+        if( shadowcasting_sight_tables && offsetDistance >= 0 ) {
+            castLight_sight<xx, xy, yx, yy, Out, update_output>(
+                output_cache, input_array, offsetX, offsetY, offsetDistance, numerator,
+                1, 1.0f, 0.0f, LIGHT_TRANSPARENCY_OPEN_AIR );
+        } else {
+            castLight<xx, xy, yx, yy, float, Out, sight_calc, sight_check, update_output,
+                      accumulate_transparency>(
+                          output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+        }
+    }
+};
+
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
@@ -1129,25 +1521,51 @@ void castLightAll( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                    const T( &input_array )[MAPSIZE_X][MAPSIZE_Y],
                    const int offsetX, const int offsetY, int offsetDistance, T numerator )
 {
-    castLight<0, 1, 1, 0, T, Out, calc, check, update_output, accumulate>(
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-    castLight<1, 0, 0, 1, T, Out, calc, check, update_output, accumulate>(
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-
-    castLight < 0, -1, 1, 0, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-    castLight < -1, 0, 0, 1, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-
-    castLight < 0, 1, -1, 0, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-    castLight < 1, 0, 0, -1, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-
-    castLight < 0, -1, -1, 0, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
-    castLight < -1, 0, 0, -1, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+    const auto cast_octant = [&]( const int octant ) {
+        switch( octant ) {
+            case 0:
+                octant_caster<0, 1, 1, 0, T, Out, calc, check, update_output, accumulate>::cast(
+                    output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 1:
+                octant_caster<1, 0, 0, 1, T, Out, calc, check, update_output, accumulate>::cast(
+                    output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 2:
+                octant_caster < 0, -1, 1, 0, T, Out, calc, check, update_output, accumulate >::cast(
+                    output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 3:
+                octant_caster < -1, 0, 0, 1, T, Out, calc, check, update_output, accumulate >::cast(
+                    output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 4:
+                octant_caster < 0, 1, -1, 0, T, Out, calc, check, update_output, accumulate >::cast(
+                    output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 5:
+                octant_caster < 1, 0, 0, -1, T, Out, calc, check, update_output, accumulate >::cast(
+                    output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 6:
+                octant_caster < 0, -1, -1, 0, T, Out, calc, check, update_output, accumulate >
+                ::cast( output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+            case 7:
+                octant_caster < -1, 0, 0, -1, T, Out, calc, check, update_output, accumulate >
+                ::cast( output_cache, input_array, offsetX, offsetY, offsetDistance, numerator );
+                break;
+        }
+    };
+
+    thread_pool *const pool = parallel_octants<Out>::value ? shadowcasting_pool() : nullptr;
+    if( pool != nullptr ) {
+        cast_octants_in_parallel( *pool, cast_octant );
+    } else {
+        for( int octant = 0; octant < 8; octant++ ) {
+            cast_octant( octant );
+        }
+    }
 }
 
 template void castLightAll<float, four_quadrants, sight_calc, sight_check,
@@ -1300,8 +1718,14 @@ static bool light_check( const float &transparency, const float &intensity )
 void map::apply_light_source( const tripoint &p, float luminance )
 {
     auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
+    apply_light_source( p, luminance, cache.lm, cache.sm );
+}
+
+void map::apply_light_source( const tripoint &p, float luminance,
+                              four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                              float ( &sm )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    auto &cache = get_cache( p.z );
     float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
     float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
 
@@ -1378,6 +1802,55 @@ void map::apply_light_source( const tripoint &p, float luminance )
     }
 }
 
+// Light a task accumulates its share of the sources into, see map::apply_light_sources.
+struct light_accumulator {
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+    float sm[MAPSIZE_X][MAPSIZE_Y];
+};
+static std::vector<std::unique_ptr<light_accumulator>> light_accumulators;
+
+void map::apply_light_sources( const std::vector<std::pair<tripoint, float>> &sources,
+                               four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                               float ( &sm )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    thread_pool *const pool = shadowcasting_pool();
+    const int num_tasks = pool == nullptr ? 1 :
+                          std::min( pool->size(), static_cast<int>( sources.size() ) );
+    if( num_tasks <= 1 ) {
+        for( const std::pair<tripoint, float> &source : sources ) {
+            apply_light_source( source.first, source.second, lm, sm );
+        }
+        return;
+    }
+
+    while( static_cast<int>( light_accumulators.size() ) < num_tasks ) {
+        light_accumulators.emplace_back( std::make_unique<light_accumulator>() );
+    }
+    pool->run( num_tasks, [&]( const int task ) {
+        light_accumulator &acc = *light_accumulators[task];
+        std::memset( acc.lm, 0, sizeof( acc.lm ) );
+        std::memset( acc.sm, 0, sizeof( acc.sm ) );
+        for( size_t i = task; i < sources.size(); i += num_tasks ) {
+            apply_light_source( sources[i].first, sources[i].second, acc.lm, acc.sm );
+        }
+    } );
+    // Casting light only ever raises a tile to the maximum of its light and the new light,
+    // so merging the same way gives the result of applying the sources one after another.
+    pool->run( num_tasks, [&]( const int task ) {
+        const int min_x = MAPSIZE_X * task / num_tasks;
+        const int max_x = MAPSIZE_X * ( task + 1 ) / num_tasks;
+        for( int i = 0; i < num_tasks; i++ ) {
+            const light_accumulator &acc = *light_accumulators[i];
+            for( int x = min_x; x < max_x; x++ ) {
+                for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                    lm[x][y] = elementwise_max( lm[x][y], acc.lm[x][y] );
+                    sm[x][y] = std::max( sm[x][y], acc.sm[x][y] );
+                }
+            }
+        }
+    } );
+}
+
 void map::apply_directional_light( const tripoint &p, int direction, float luminance )
 {
     const int x = p.x;
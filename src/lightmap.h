@@ -3,6 +3,7 @@
 #define LIGHTMAP_H
 
 #include <cmath>
+#include <cstdint>
 
 #define LIGHT_SOURCE_LOCAL  0.1f
 #define LIGHT_SOURCE_BRIGHT 10
@@ -25,7 +26,7 @@
 
 #define LIGHT_RANGE(b) static_cast<int>( -log(LIGHT_AMBIENT_LOW / static_cast<float>(b)) * (1.0 / LIGHT_TRANSPARENCY_OPEN_AIR) )
 
-enum lit_level {
+enum lit_level : uint8_t {
     LL_DARK = 0,
     LL_LOW, // Hard to see
     LL_BRIGHT_ONLY, // bright but indistinct
@@ -22,6 +22,7 @@
 #else
 #include <signal.h>
 #endif
+#include "catacharset.h"
 #include "color.h"
 #include "crash.h"
 #include "cursesdef.h"
@@ -35,6 +36,7 @@
 #include "output.h"
 #include "path_info.h"
 #include "rng.h"
+#include "submap_region.h"
 #include "translations.h"
 #include "input.h"
 #include "type_id.h"
@@ -142,6 +144,7 @@ int main( int argc, char *argv[] )
     dump_mode dmode = dump_mode::TSV;
     std::vector<std::string> opts;
     std::string world; /** if set try to load first save in this world on startup */
+    std::string convert_maps; /** if set convert the maps of @ref world into this format and exit */
 
 #if defined(__ANDROID__)
     // Start the standard output logging redirector
@@ -182,7 +185,7 @@ int main( int argc, char *argv[] )
         const char *section_default = nullptr;
         const char *section_map_sharing = "Map sharing";
         const char *section_user_directory = "User directories";
-        const std::array<arg_handler, 12> first_pass_arguments = {{
+        const std::array<arg_handler, 13> first_pass_arguments = {{
                 {
                     "--seed", "<string of letters and or numbers>",
                     "Sets the random number generator's seed value",
@@ -263,6 +266,22 @@ int main( int argc, char *argv[] )
                         return 1;
                     }
                 },
+                {
+                    "--convert-maps", "<regions|quads> <world>",
+                    "Converts the maps of a world into region files or quad files",
+                    section_default,
+                    [&convert_maps, &world]( int n, const char *params[] ) -> int {
+                        if( n < 2 || ( strcmp( params[0], "regions" ) != 0 &&
+                                       strcmp( params[0], "quads" ) != 0 ) )
+                        {
+                            return -1;
+                        }
+                        test_mode = true;
+                        convert_maps = params[0];
+                        world = params[1];
+                        return 2;
+                    }
+                },
                 {
                     "--basepath", "<path>",
                     "Base path for all game data subdirectories",
@@ -581,6 +600,25 @@ int main( int argc, char *argv[] )
     get_options().load();
     set_language();
 
+    if( !convert_maps.empty() ) {
+        const std::string map_directory = FILENAMES["savedir"] + utf8_to_native( world ) + "/maps";
+        if( !dir_exist( map_directory ) ) {
+            printf( "Can't find the maps of world \"%s\" in %s\n", world.c_str(),
+                    map_directory.c_str() );
+            exit( 1 );
+        }
+        try {
+            const int converted = convert_maps == "regions" ?
+                                  convert_quads_to_regions( map_directory ) :
+                                  convert_regions_to_quads( map_directory );
+            printf( "Converted %d submaps\n", converted );
+        } catch( const std::exception &err ) {
+            printf( "Converting the maps failed: %s\n", err.what() );
+            exit( 1 );
+        }
+        exit( 0 );
+    }
+
 #if defined(TILES)
     SDL_version compiled;
     SDL_VERSION( &compiled );
@@ -227,11 +227,11 @@ void map::add_vehicle_to_cache( vehicle *veh )
             continue;
         }
         const tripoint p = veh->global_part_pos3( *it );
-        ch.veh_cached_parts.insert( std::make_pair( p,
-                                    std::make_pair( veh, partid ) ) );
-        if( inbounds( p ) ) {
-            ch.veh_exists_at[p.x][p.y] = true;
+        if( !inbounds( p ) || ch.veh_part_index[p.x][p.y] != 0 ) {
+            continue;
         }
+        ch.veh_cached_parts.push_back( { veh, partid, point( p.x, p.y ) } );
+        ch.veh_part_index[p.x][p.y] = static_cast<uint16_t>( ch.veh_cached_parts.size() );
     }
 }
 
@@ -244,20 +244,22 @@ void map::update_vehicle_cache( vehicle *veh, const int old_zlevel )
 
     // Existing must be cleared
     auto &ch = get_cache( old_zlevel );
-    auto it = ch.veh_cached_parts.begin();
-    const auto end = ch.veh_cached_parts.end();
-    while( it != end ) {
-        if( it->second.first == veh ) {
-            const tripoint p = it->first;
-            if( inbounds( p ) ) {
-                ch.veh_exists_at[p.x][p.y] = false;
-            }
-            ch.veh_cached_parts.erase( it++ );
-            // If something was resting on vehicle, drop it
-            support_dirty( tripoint( p.x, p.y, old_zlevel + 1 ) );
-        } else {
-            ++it;
+    auto &parts = ch.veh_cached_parts;
+    for( size_t i = 0; i < parts.size(); ) {
+        if( parts[i].veh != veh ) {
+            ++i;
+            continue;
+        }
+        const point p = parts[i].pos;
+        ch.veh_part_index[p.x][p.y] = 0;
+        // Move the last part into the hole, so the list stays packed
+        if( i + 1 != parts.size() ) {
+            parts[i] = parts.back();
+            ch.veh_part_index[parts[i].pos.x][parts[i].pos.y] = static_cast<uint16_t>( i + 1 );
         }
+        parts.pop_back();
+        // If something was resting on vehicle, drop it
+        support_dirty( tripoint( p.x, p.y, old_zlevel + 1 ) );
     }
 
     add_vehicle_to_cache( veh );
@@ -266,14 +268,10 @@ void map::update_vehicle_cache( vehicle *veh, const int old_zlevel )
 void map::clear_vehicle_cache( const int zlev )
 {
     auto &ch = get_cache( zlev );
-    while( !ch.veh_cached_parts.empty() ) {
-        const auto part = ch.veh_cached_parts.begin();
-        const auto &p = part->first;
-        if( inbounds( p ) ) {
-            ch.veh_exists_at[p.x][p.y] = false;
-        }
-        ch.veh_cached_parts.erase( part );
+    for( const cached_vehicle_part &part : ch.veh_cached_parts ) {
+        ch.veh_part_index[part.pos.x][part.pos.y] = 0;
     }
+    ch.veh_cached_parts.clear();
 }
 
 void map::clear_vehicle_list( const int zlev )
@@ -327,6 +325,8 @@ std::unique_ptr<vehicle> map::detach_vehicle( vehicle *veh )
             reset_vehicle_cache( zlev );
             std::unique_ptr<vehicle> result = std::move( current_submap->vehicles[i] );
             current_submap->vehicles.erase( current_submap->vehicles.begin() + i );
+            MAPBUFFER.vehicles_changed( tripoint( abs_sub.x + veh->smx, abs_sub.y + veh->smy,
+                                                  zlev ) );
             if( veh->tracking_on ) {
                 overmap_buffer.remove_vehicle( veh );
             }
@@ -875,20 +875,14 @@ const vehicle *map::veh_at_internal( const tripoint &p, int &part_num ) const
 {
     // This function is called A LOT. Move as much out of here as possible.
     const auto &ch = get_cache_ref( p.z );
-    if( !ch.veh_in_active_range || !ch.veh_exists_at[p.x][p.y] ) {
+    if( !ch.veh_in_active_range || ch.veh_part_index[p.x][p.y] == 0 ) {
         part_num = -1;
         return nullptr; // Clear cache indicates no vehicle. This should optimize a great deal.
     }
 
-    const auto it = ch.veh_cached_parts.find( p );
-    if( it != ch.veh_cached_parts.end() ) {
-        part_num = it->second.second;
-        return it->second.first;
-    }
-
-    debugmsg( "vehicle part cache indicated vehicle not found: %d %d %d", p.x, p.y, p.z );
-    part_num = -1;
-    return nullptr;
+    const cached_vehicle_part &part = ch.veh_cached_parts[ch.veh_part_index[p.x][p.y] - 1];
+    part_num = part.part;
+    return part.veh;
 }
 
 vehicle *map::veh_at_internal( const tripoint &p, int &part_num )
@@ -1087,11 +1081,14 @@ vehicle *map::displace_vehicle( tripoint &p, const tripoint &dp )
     // Invalidate vehicle's point cache
     veh->occupied_cache_time = calendar::before_time_starts;
     if( src_submap != dst_submap ) {
+        const tripoint src_submap_pos( abs_sub.x + veh->smx, abs_sub.y + veh->smy, src.z );
         veh->set_submap_moved( int( p2.x / SEEX ), int( p2.y / SEEY ) );
         auto src_submap_veh_it = src_submap->vehicles.begin() + our_i;
         dst_submap->vehicles.push_back( std::move( *src_submap_veh_it ) );
         src_submap->vehicles.erase( src_submap_veh_it );
         dst_submap->is_uniform = false;
+        MAPBUFFER.vehicles_changed( src_submap_pos );
+        MAPBUFFER.vehicles_changed( tripoint( abs_sub.x + veh->smx, abs_sub.y + veh->smy, p2.z ) );
     }
 
     p = p2;
@@ -1270,7 +1267,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture )
     }
 
     if( old_t.transparent != new_t.transparent ) {
-        set_transparency_cache_dirty( p.z );
+        set_transparency_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_INDOORS ) != new_t.has_flag( TFLAG_INDOORS ) ) {
@@ -1283,7 +1280,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture )
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1530,7 +1527,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     }
 
     if( old_t.transparent != new_t.transparent ) {
-        set_transparency_cache_dirty( p.z );
+        set_transparency_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_INDOORS ) != new_t.has_flag( TFLAG_INDOORS ) ) {
@@ -1545,7 +1542,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.x, p.y, p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -2582,7 +2579,7 @@ bool map::is_outside( const int x, const int y ) const
     }
 
     const auto &outside_cache = get_cache_ref( abs_sub.z ).outside_cache;
-    return outside_cache[x][y];
+    return outside_cache[level_cache::tile_offset( x, y )];
 }
 
 bool map::is_outside( const tripoint &p ) const
@@ -2592,7 +2589,7 @@ bool map::is_outside( const tripoint &p ) const
     }
 
     const auto &outside_cache = get_cache_ref( p.z ).outside_cache;
-    return outside_cache[p.x][p.y];
+    return outside_cache[level_cache::tile_offset( p.x, p.y )];
 }
 
 bool map::is_last_ter_wall( const bool no_furn, const int x, const int y,
@@ -2728,7 +2725,7 @@ void map::decay_fields_and_scent( const time_duration &amount )
                     const int y = sy + smy * SEEY;
 
                     field &fields = cur_submap->fld[sx][sy];
-                    if( !outside_cache[x][y] ) {
+                    if( !outside_cache[level_cache::tile_offset( x, y )] ) {
                         to_proc -= fields.field_count();
                         continue;
                     }
@@ -4563,25 +4560,27 @@ void map::process_items( const bool active, map::map_process_func processor,
         for( const tripoint &pos : submaps_with_vehicles ) {
             submap *const current_submap = get_submap_at_grid( pos );
             // Vehicles first in case they get blown up and drop active items on the map.
-            process_items_in_vehicles( *current_submap, pos.z, processor, signal );
+            process_items_in_vehicles( *current_submap, pos.z, active, processor, signal );
         }
     }
     for( const tripoint &abs_pos : submaps_with_active_items ) {
         const tripoint local_pos = abs_pos - abs_sub;
         submap *const current_submap = get_submap_at_grid( local_pos );
         if( !active || !current_submap->active_items.empty() ) {
-            process_items_in_submap( *current_submap, local_pos, processor, signal );
+            process_items_in_submap( *current_submap, local_pos, active, processor, signal );
         }
     }
 }
 
 void map::process_items_in_submap( submap &current_submap, const tripoint &gridp,
-                                   map::map_process_func processor, const std::string &signal )
+                                   const bool active, map::map_process_func processor,
+                                   const std::string &signal )
 {
     // Get a COPY of the active item list for this submap.
     // If more are added as a side effect of processing, they are ignored this turn.
     // If they are destroyed before processing, they don't get processed.
-    std::vector<item_reference> active_items = current_submap.active_items.get_for_processing();
+    std::vector<item_reference> active_items = active ?
+            current_submap.active_items.get_for_processing() : current_submap.active_items.get();
     const point grid_offset( gridp.x * SEEX, gridp.y * SEEY );
     for( item_reference &active_item_ref : active_items ) {
         if( !active_item_ref.item_ref ) {
@@ -4600,7 +4599,7 @@ void map::process_items_in_submap( submap &current_submap, const tripoint &gridp
     }
 }
 
-void map::process_items_in_vehicles( submap &current_submap, const int gridz,
+void map::process_items_in_vehicles( submap &current_submap, const int gridz, const bool active,
                                      map::map_process_func processor, const std::string &signal )
 {
     // a copy, important if the vehicle list changes because a
@@ -4618,12 +4617,13 @@ void map::process_items_in_vehicles( submap &current_submap, const int gridz,
             continue;
         }
 
-        process_items_in_vehicle( *cur_veh, current_submap, gridz, processor, signal );
+        process_items_in_vehicle( *cur_veh, current_submap, gridz, active, processor, signal );
     }
 }
 
 void map::process_items_in_vehicle( vehicle &cur_veh, submap &current_submap, const int /*gridz*/,
-                                    map::map_process_func processor, const std::string &signal )
+                                    const bool active, map::map_process_func processor,
+                                    const std::string &signal )
 {
     const bool engine_heater_is_on = cur_veh.has_part( "E_HEATER", true ) && cur_veh.engine_on;
     for( const vpart_reference &vp : cur_veh.get_any_parts( VPFLAG_FLUIDTANK ) ) {
@@ -4635,7 +4635,9 @@ void map::process_items_in_vehicle( vehicle &cur_veh, submap &current_submap, co
         process_vehicle_items( cur_veh, vp.part_index() );
     }
 
-    for( item_reference &active_item_ref : cur_veh.active_items.get_for_processing() ) {
+    std::vector<item_reference> active_items = active ?
+            cur_veh.active_items.get_for_processing() : cur_veh.active_items.get();
+    for( item_reference &active_item_ref : active_items ) {
         if( empty( cargo_parts ) ) {
             return;
         } else if( !active_item_ref.item_ref ) {
@@ -5406,25 +5408,33 @@ bool map::add_field( const tripoint &p, const field_id type, int intensity,
     submap *const current_submap = get_submap_at( p, l );
     current_submap->is_uniform = false;
 
-    if( current_submap->fld[l.x][l.y].add_field( type, intensity, age ) ) {
+    field &curfield = current_submap->fld[l.x][l.y];
+    const field_entry *const existing = curfield.find_field( type );
+    const int old_intensity = existing ? existing->get_field_intensity() : 0;
+    if( curfield.add_field( type, intensity, age ) ) {
         //Only adding it to the count if it doesn't exist.
         if( ! current_submap->field_count++ ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
                                                   p.y / SEEX ) * MAPSIZE ) ) );
         }
     }
+    const int new_intensity = curfield.find_field( type )->get_field_intensity();
 
     if( g != nullptr && this == &g->m && p == g->u.pos() ) {
         creature_in_field( g->u ); //Hit the player with the field if it spawned on top of them.
     }
 
-    // Dirty the transparency cache now that field processing doesn't always do it
-    // TODO: Make it skip transparent fields
-    set_transparency_cache_dirty( p.z );
-
+    // Dirty the transparency cache now that field processing doesn't always do it,
+    // unless the field stayed transparent.
     const field_t &ft = all_field_types_enum_list[type];
+    if( new_intensity != old_intensity &&
+        ( ( old_intensity > 0 && !ft.transparent[old_intensity - 1] ) ||
+          !ft.transparent[new_intensity - 1] ) ) {
+        set_transparency_cache_dirty( p );
+    }
+
     if( field_type_dangerous( type ) ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     // Ensure blood type fields don't hang in the air
@@ -5453,14 +5463,14 @@ void map::remove_field( const tripoint &p, const field_id field_to_remove )
         const auto &fdata = all_field_types_enum_list[ field_to_remove ];
         for( bool i : fdata.transparent ) {
             if( !i ) {
-                set_transparency_cache_dirty( p.z );
+                set_transparency_cache_dirty( p );
                 break;
             }
         }
 
         for( bool danger : fdata.dangerous ) {
             if( danger ) {
-                set_pathfinding_cache_dirty( p.z );
+                set_pathfinding_cache_dirty( p );
                 break;
             }
         }
@@ -6692,6 +6702,44 @@ void map::saven( const int gridx, const int gridy, const int gridz )
     MAPBUFFER.add_submap( abs_x, abs_y, abs_z, submap_to_save );
 }
 
+void map::prefetch_submaps( const tripoint &p, const point &velocity )
+{
+    // Decoding still happens on the main thread, so reading further ahead mostly spends
+    // memory on submaps that may never be reached.
+    static constexpr int lookahead_turns = 5;
+    if( velocity == point_zero ) {
+        return;
+    }
+    // The shift game::update_map would do for a player at pos, one submap further along the
+    // way so the submaps are read before the shift that needs them.
+    const auto predicted_shift = []( const int pos, const int speed, const int center,
+    const int size ) {
+        const int ahead = pos + speed * lookahead_turns + ( speed > 0 ? size : -size );
+        if( ahead < center ) {
+            return -( ( center - ahead + size - 1 ) / size );
+        }
+        return ( ahead - center ) / size;
+    };
+    const int shiftx = predicted_shift( p.x, velocity.x, HALF_MAPSIZE_X, SEEX );
+    const int shifty = predicted_shift( p.y, velocity.y, HALF_MAPSIZE_Y, SEEY );
+    if( shiftx == 0 && shifty == 0 ) {
+        return;
+    }
+    const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+    const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    for( int gridx = shiftx; gridx < shiftx + my_MAPSIZE; gridx++ ) {
+        for( int gridy = shifty; gridy < shifty + my_MAPSIZE; gridy++ ) {
+            if( gridx >= 0 && gridx < my_MAPSIZE && gridy >= 0 && gridy < my_MAPSIZE ) {
+                // Already on the map.
+                continue;
+            }
+            for( int gridz = minz; gridz <= maxz; gridz++ ) {
+                MAPBUFFER.prefetch( tripoint( abs_sub.x + gridx, abs_sub.y + gridy, gridz ) );
+            }
+        }
+    }
+}
+
 // worldx & worldy specify where in the world this is;
 // gridx & gridy specify which nonant:
 // 0,0  1,0  2,0
@@ -6821,6 +6869,7 @@ void map::loadn( const int gridx, const int gridy, const int gridz, const bool u
             iter = veh_vec.erase( iter );
         }
     }
+    MAPBUFFER.vehicles_changed( tripoint( absx, absy, gridz ) );
 
     // Update vehicle data
     if( update_vehicles ) {
@@ -7691,8 +7740,7 @@ void map::build_outside_cache( const int zlev )
 
     auto &outside_cache = ch.outside_cache;
     if( zlev < 0 ) {
-        std::uninitialized_fill_n(
-            &outside_cache[0][0], ( MAPSIZE_X ) * ( MAPSIZE_Y ), false );
+        outside_cache.reset();
         return;
     }
 
@@ -7724,7 +7772,9 @@ void map::build_outside_cache( const int zlev )
 
     // Copy the padded cache back to the proper one, but with no padding
     for( int x = 0; x < SEEX * my_MAPSIZE; x++ ) {
-        std::copy_n( &padded_cache[x + 1][1], SEEX * my_MAPSIZE, &outside_cache[x][0] );
+        for( int y = 0; y < SEEY * my_MAPSIZE; y++ ) {
+            outside_cache[level_cache::tile_offset( x, y )] = padded_cache[x + 1][y + 1];
+        }
     }
 
     ch.outside_cache_dirty = false;
@@ -7873,7 +7923,7 @@ void map::do_vehicle_caching( int z )
             }
 
             if( vehicle_is_opaque || vp.is_inside() ) {
-                outside_cache[px][py] = false;
+                outside_cache.reset( level_cache::tile_offset( px, py ) );
             }
 
             if( vp.has_feature( VPFLAG_BOARDABLE ) && !vp.part().is_broken() ) {
@@ -7898,7 +7948,11 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     // The tile player is standing on should always be transparent
     const tripoint &p = g->u.pos();
     if( ( has_furn( p ) && !furn( p ).obj().transparent ) || !ter( p ).obj().transparent ) {
-        get_cache( p.z ).transparency_cache[p.x][p.y] = LIGHT_TRANSPARENCY_CLEAR;
+        level_cache &ch = get_cache( p.z );
+        if( ch.transparency_cache[p.x][p.y] != LIGHT_TRANSPARENCY_CLEAR ) {
+            ch.transparency_cache[p.x][p.y] = LIGHT_TRANSPARENCY_CLEAR;
+            ch.static_light_dirty.set( p.x / SEEX + ( p.y / SEEY ) * MAPSIZE );
+        }
     }
 
     // Initial value is illegal player position.
@@ -8465,26 +8519,28 @@ const level_cache &map::access_cache( int zlev ) const
 level_cache::level_cache()
 {
     const int map_dimensions = MAPSIZE_X * MAPSIZE_Y;
-    transparency_cache_dirty = true;
+    transparency_cache_dirty.set();
     outside_cache_dirty = true;
     floor_cache_dirty = false;
     constexpr four_quadrants four_zeros( 0.0f );
     std::fill_n( &lm[0][0], map_dimensions, four_zeros );
     std::fill_n( &sm[0][0], map_dimensions, 0.0f );
     std::fill_n( &light_source_buffer[0][0], map_dimensions, 0.0f );
-    std::fill_n( &outside_cache[0][0], map_dimensions, false );
     std::fill_n( &floor_cache[0][0], map_dimensions, false );
     std::fill_n( &transparency_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &seen_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &camera_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &visibility_cache[0][0], map_dimensions, LL_DARK );
     veh_in_active_range = false;
-    std::fill_n( &veh_exists_at[0][0], map_dimensions, false );
+    std::fill_n( &veh_part_index[0][0], map_dimensions, 0 );
 }
 
 pathfinding_cache::pathfinding_cache()
 {
     dirty = true;
+    dirty_submaps.set();
+    dirty_clusters.set();
+    std::uninitialized_fill_n( &special[0][0], MAPSIZE_X * MAPSIZE_Y, PF_NORMAL );
 }
 
 pathfinding_cache::~pathfinding_cache() = default;
@@ -8497,7 +8553,18 @@ pathfinding_cache &map::get_pathfinding_cache( int zlev ) const
 void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
-        get_pathfinding_cache( zlev ).dirty = true;
+        auto &cache = get_pathfinding_cache( zlev );
+        cache.dirty = true;
+        cache.dirty_submaps.set();
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    if( inbounds( p ) ) {
+        auto &cache = get_pathfinding_cache( p.z );
+        cache.dirty = true;
+        cache.dirty_submaps.set( p.x / SEEX + ( p.y / SEEY ) * MAPSIZE );
     }
 }
 
@@ -8522,10 +8589,26 @@ void map::update_pathfinding_cache( int zlev ) const
         return;
     }
 
-    std::uninitialized_fill_n( &cache.special[0][0], MAPSIZE_X * MAPSIZE_Y, PF_NORMAL );
-
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !cache.dirty_submaps[smx + smy * MAPSIZE] ) {
+                continue;
+            }
+            // Entrances on the borders of neighboring clusters may have changed too
+            cache.dirty_clusters.set( smx + smy * MAPSIZE );
+            if( smx > 0 ) {
+                cache.dirty_clusters.set( smx - 1 + smy * MAPSIZE );
+            }
+            if( smx + 1 < my_MAPSIZE ) {
+                cache.dirty_clusters.set( smx + 1 + smy * MAPSIZE );
+            }
+            if( smy > 0 ) {
+                cache.dirty_clusters.set( smx + ( smy - 1 ) * MAPSIZE );
+            }
+            if( smy + 1 < my_MAPSIZE ) {
+                cache.dirty_clusters.set( smx + ( smy + 1 ) * MAPSIZE );
+            }
+
             const auto cur_submap = get_submap_at_grid( { smx, smy, zlev } );
 
             tripoint p( 0, 0, zlev );
@@ -8583,7 +8666,9 @@ void map::update_pathfinding_cache( int zlev ) const
         }
     }
 
+    cache.dirty_submaps.reset();
     cache.dirty = false;
+    cache.generation++;
 }
 
 void map::clip_to_bounds( tripoint &p ) const
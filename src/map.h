@@ -23,6 +23,7 @@
 #include "item.h"
 #include "item_stack.h"
 #include "lightmap.h"
+#include "point.h"
 #include "shadowcasting.h"
 #include "type_id.h"
 #include "units.h"
@@ -87,7 +88,9 @@ class map;
 
 enum ter_bitflags : int;
 struct pathfinding_cache;
+struct pathfinding_flow_field;
 struct pathfinding_settings;
+enum pf_special : char;
 template<typename T>
 struct weighted_int_list;
 
@@ -143,11 +146,26 @@ struct bash_params {
     bool bashing_from_above;
 };
 
+/** A vehicle part occupying a map tile, see @ref level_cache::veh_part_index */
+struct cached_vehicle_part {
+    vehicle *veh;
+    int part;
+    point pos;
+};
+
 struct level_cache {
     level_cache(); // Zeros all relevant values
     level_cache( const level_cache &other ) = default;
 
-    bool transparency_cache_dirty;
+    /** Offset of a tile in the per-tile bitsets below, same x-major order as the arrays. */
+    static constexpr size_t tile_offset( const int x, const int y ) {
+        return static_cast<size_t>( x * MAPSIZE_Y + y );
+    }
+
+    // Submaps (smx + smy * MAPSIZE) whose transparency needs to be recalculated
+    std::bitset<MAPSIZE *MAPSIZE> transparency_cache_dirty;
+    // Submaps whose transparency changed since the static lights of this level were last cast
+    std::bitset<MAPSIZE *MAPSIZE> static_light_dirty;
     bool outside_cache_dirty;
     bool floor_cache_dirty;
 
@@ -156,7 +174,7 @@ struct level_cache {
     // To prevent redundant ray casting into neighbors: precalculate bulk light source positions.
     // This is only valid for the duration of generate_lightmap
     float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
-    bool outside_cache[MAPSIZE_X][MAPSIZE_Y];
+    std::bitset<MAPSIZE_X *MAPSIZE_Y> outside_cache;
     bool floor_cache[MAPSIZE_X][MAPSIZE_Y];
     float transparency_cache[MAPSIZE_X][MAPSIZE_Y];
     float seen_cache[MAPSIZE_X][MAPSIZE_Y];
@@ -166,12 +184,28 @@ struct level_cache {
     std::bitset<MAPSIZE *MAPSIZE> field_cache;
 
     bool veh_in_active_range;
-    bool veh_exists_at[MAPSIZE_X][MAPSIZE_Y];
-    std::map< tripoint, std::pair<vehicle *, int> > veh_cached_parts;
+    // Vehicle part at each tile, as 1-based index into veh_cached_parts (0 means no vehicle).
+    // Only the first part added at a tile is recorded.
+    uint16_t veh_part_index[MAPSIZE_X][MAPSIZE_Y];
+    std::vector<cached_vehicle_part> veh_cached_parts;
     std::set<vehicle *> vehicle_list;
     std::set<vehicle *> zone_vehicles;
 };
 
+/**
+ * Light cast by the stationary light sources (terrain, items and fields) of one z-level.
+ * It is kept between calls to @ref map::generate_lightmap and only cast again when the
+ * sources change or the transparency changes within their reach.
+ */
+struct static_light_cache {
+    bool valid = false;
+    // abs_sub of the map and z-level the light was cast on
+    tripoint origin;
+    float sources[MAPSIZE_X][MAPSIZE_Y];
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+    float sm[MAPSIZE_X][MAPSIZE_Y];
+};
+
 /**
  * Manage and cache data about a part of the map.
  *
@@ -216,7 +250,15 @@ class map
         /*@{*/
         void set_transparency_cache_dirty( const int zlev ) {
             if( inbounds_z( zlev ) ) {
-                get_cache( zlev ).transparency_cache_dirty = true;
+                get_cache( zlev ).transparency_cache_dirty.set();
+            }
+        }
+
+        /** Only the submap containing p will have its transparency recalculated */
+        void set_transparency_cache_dirty( const tripoint &p ) {
+            if( inbounds( p ) ) {
+                const size_t submap = p.x / SEEX + ( p.y / SEEY ) * MAPSIZE;
+                get_cache( p.z ).transparency_cache_dirty.set( submap );
             }
         }
 
@@ -233,6 +275,8 @@ class map
         }
 
         void set_pathfinding_cache_dirty( const int zlev );
+        /** Only the submap containing p will have its pathfinding data recalculated */
+        void set_pathfinding_cache_dirty( const tripoint &p );
         /*@}*/
 
         void set_memory_seen_cache_dirty( const tripoint &p ) {
@@ -246,7 +290,7 @@ class map
             if( inbounds_z( zlev ) ) {
                 level_cache &ch = get_cache( zlev );
                 ch.floor_cache_dirty = true;
-                ch.transparency_cache_dirty = true;
+                ch.transparency_cache_dirty.set();
                 ch.outside_cache_dirty = true;
             }
         }
@@ -351,6 +395,12 @@ class map
          * Note: the map must have been loaded before this can be called.
          */
         void shift( const int sx, const int sy );
+        /**
+         * Starts reading the saved submaps that will shift onto the map soon in the
+         * background (see @ref mapbuffer::prefetch), assuming whoever is at @p p keeps
+         * moving by @p velocity tiles per turn.
+         */
+        void prefetch_submaps( const tripoint &p, const point &velocity );
         /**
          * Moves the map vertically to (not by!) newz.
          * Does not actually shift anything, only forces cache updates.
@@ -513,6 +563,18 @@ class map
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
 
+        /**
+         * Route from @p f to @p t, read from a flow field shared by everyone pathing to @p t
+         * with the same settings. The field is only built once it was requested more than
+         * once during a turn, so single creatures with unique targets still use @ref route.
+         *
+         * @param path Set to the route, or emptied if the field has none.
+         * @return false if the field gives no route and @ref route should be used.
+         */
+        bool route_from_flow_field( const tripoint &f, const tripoint &t,
+                                    const pathfinding_settings &settings,
+                                    std::vector<tripoint> &path ) const;
+
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
         void add_vehicle_to_cache( vehicle * );
@@ -1039,7 +1101,7 @@ class map
         //Spawns byproducts from items destroyed in fire.
         void create_burnproducts( const tripoint &p, const item &fuel, const units::mass &burned_mass );
         bool process_fields(); // See fields.cpp
-        bool process_fields_in_submap( submap *const current_submap,
+        void process_fields_in_submap( submap *const current_submap,
                                        const int submap_x, const int submap_y, const int submap_z ); // See fields.cpp
         /**
          * Apply field effects to the creature when it's on a square with fields.
@@ -1465,6 +1527,11 @@ class map
 
     protected:
         void generate_lightmap( int zlev );
+        /**
+         * Adds the light of the sources buffered so far in the light_source_buffer of @p zlev
+         * to its lightmap, casting it again only if needed (see @ref static_light_cache).
+         */
+        void apply_static_light_sources( int zlev );
         void build_seen_cache( const tripoint &origin, int target_z );
         void apply_character_light( player &p );
 
@@ -1560,6 +1627,17 @@ class map
         int determine_wall_corner( const tripoint &p ) const;
         // apply a circular light pattern immediately, however it's best to use...
         void apply_light_source( const tripoint &p, float luminance );
+        void apply_light_source( const tripoint &p, float luminance,
+                                 four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                 float ( &sm )[MAPSIZE_X][MAPSIZE_Y] );
+        /**
+         * Applies all of @p sources (position and luminance) to @p lm and @p sm. With parallel
+         * shadowcasting each worker thread casts a share of them into buffers of its own,
+         * which are then merged.
+         */
+        void apply_light_sources( const std::vector<std::pair<tripoint, float>> &sources,
+                                  four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                  float ( &sm )[MAPSIZE_X][MAPSIZE_Y] );
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
         void add_light_source( const tripoint &p, float luminance );
@@ -1599,12 +1677,15 @@ class map
 
         // Iterates over every item on the map, passing each item to the provided function.
         void process_items( bool active, map_process_func processor, const std::string &signal );
-        void process_items_in_submap( submap &current_submap, const tripoint &gridp,
+        // With active set only the items due for processing are passed, see
+        // active_item_cache::get_for_processing, otherwise all active items are.
+        void process_items_in_submap( submap &current_submap, const tripoint &gridp, bool active,
                                       map::map_process_func processor, const std::string &signal );
-        void process_items_in_vehicles( submap &current_submap, const int gridz,
+        void process_items_in_vehicles( submap &current_submap, const int gridz, bool active,
                                         map_process_func processor, const std::string &signal );
         void process_items_in_vehicle( vehicle &cur_veh, submap &current_submap, const int gridz,
-                                       map::map_process_func processor, const std::string &signal );
+                                       bool active, map::map_process_func processor,
+                                       const std::string &signal );
 
         /** Enum used by functors in `function_over` to control execution. */
         enum iteration_state {
@@ -1648,6 +1729,8 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        /** Allocated on first use, most maps never generate a lightmap */
+        std::unique_ptr<static_light_cache> static_lights;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
@@ -1660,6 +1743,23 @@ class map
 
         pathfinding_cache &get_pathfinding_cache( int zlev ) const;
 
+        /**
+         * Cost of stepping from @p cur onto the adjacent tile @p p for the pathfinder,
+         * not including the diagonal penalty. Negative values mean the step is impossible.
+         */
+        int pathfinding_step_cost( const tripoint &cur, const tripoint &p, pf_special p_special,
+                                   const pathfinding_settings &settings ) const;
+        void build_flow_field( pathfinding_flow_field &field, const pathfinding_cache &cache ) const;
+        /**
+         * Tile-level A* used by @ref route.
+         * @param corridor If not null, only submap-sized clusters set in it (indexed
+         * by smx + smy * MAPSIZE) are searched.
+         */
+        std::vector<tripoint> route_in_corridor( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings,
+                const std::set<tripoint> &pre_closed,
+                const std::bitset<MAPSIZE * MAPSIZE> *corridor ) const;
+
         visibility_variables visibility_variables_cache;
 
     public:
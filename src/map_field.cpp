@@ -7,6 +7,7 @@
 #include <tuple>
 #include <iterator>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <utility>
@@ -100,36 +101,84 @@ void map::create_burnproducts( const tripoint &p, const item &fuel, const units:
     }
 }
 
+/**
+ * Everything about the fields in the submap that the transparency cache depends on:
+ * the position, type and intensity of each field that isn't transparent.
+ */
+static std::vector<int> opaque_fields( const submap &sm )
+{
+    std::vector<int> result;
+    if( sm.field_count == 0 ) {
+        return result;
+    }
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            for( const auto &fld : sm.fld[x][y] ) {
+                const field_entry &cur = fld.second;
+                const int intensity = cur.get_field_intensity();
+                if( !all_field_types_enum_list[fld.first].transparent[intensity - 1] ) {
+                    const int tile = x * SEEY + y;
+                    result.push_back( ( tile * num_fields + fld.first ) * 4 + intensity );
+                }
+            }
+        }
+    }
+    return result;
+}
+
 bool map::process_fields()
 {
-    bool dirty_transparency_cache = false;
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+
+    // Fields change their own submap and spread into the neighbouring ones (including
+    // those above and below). Remember how those looked, so only the submaps where the
+    // transparency actually changed are dirtied afterwards, not all of them every turn.
+    // New fields dirty their submap themselves, see map::add_field.
+    std::map<tripoint, std::vector<int>> opaque_before;
     for( int z = minz; z <= maxz; z++ ) {
-        bool zlev_dirty = false;
-        auto &field_cache = get_cache( z ).field_cache;
+        const auto &field_cache = get_cache( z ).field_cache;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
-                if( field_cache[ x + ( y * MAPSIZE ) ] ) {
-                    submap *const current_submap = get_submap_at_grid( { x, y, z } );
-                    const bool cur_dirty = process_fields_in_submap( current_submap, x, y, z );
-                    zlev_dirty |= cur_dirty;
+                if( !field_cache[ x + ( y * MAPSIZE ) ] ) {
+                    continue;
+                }
+                const int max_x = std::min( x + 1, my_MAPSIZE - 1 );
+                const int max_y = std::min( y + 1, my_MAPSIZE - 1 );
+                for( int nz = std::max( z - 1, minz ); nz <= std::min( z + 1, maxz ); nz++ ) {
+                    for( int nx = std::max( x - 1, 0 ); nx <= max_x; nx++ ) {
+                        for( int ny = std::max( y - 1, 0 ); ny <= max_y; ny++ ) {
+                            const tripoint grid( nx, ny, nz );
+                            if( opaque_before.count( grid ) == 0 ) {
+                                opaque_before[grid] = opaque_fields( *get_submap_at_grid( grid ) );
+                            }
+                        }
+                    }
                 }
             }
         }
+    }
 
-        if( zlev_dirty ) {
-            // For now, just always dirty the transparency cache
-            // when a field might possibly be changed.
-            // TODO: check if there are any fields(mostly fire)
-            //       that frequently change, if so set the dirty
-            //       flag, otherwise only set the dirty flag if
-            //       something actually changed
-            set_transparency_cache_dirty( z );
-            dirty_transparency_cache = true;
+    for( int z = minz; z <= maxz; z++ ) {
+        const auto &field_cache = get_cache( z ).field_cache;
+        for( int x = 0; x < my_MAPSIZE; x++ ) {
+            for( int y = 0; y < my_MAPSIZE; y++ ) {
+                if( !field_cache[ x + ( y * MAPSIZE ) ] ) {
+                    continue;
+                }
+                process_fields_in_submap( get_submap_at_grid( { x, y, z } ), x, y, z );
+            }
         }
     }
 
+    bool dirty_transparency_cache = false;
+    for( const auto &elem : opaque_before ) {
+        const tripoint &grid = elem.first;
+        if( opaque_fields( *get_submap_at_grid( grid ) ) != elem.second ) {
+            get_cache( grid.z ).transparency_cache_dirty.set( grid.x + grid.y * MAPSIZE );
+            dirty_transparency_cache = true;
+        }
+    }
     return dirty_transparency_cache;
 }
 
@@ -157,7 +206,7 @@ Iterates over every field on every tile of the given submap given as parameter.
 This is the general update function for field effects. This should only be called once per game turn.
 If you need to insert a new field behavior per unit time add a case statement in the switch below.
 */
-bool map::process_fields_in_submap( submap *const current_submap,
+void map::process_fields_in_submap( submap *const current_submap,
                                     const int submap_x, const int submap_y, const int submap_z )
 {
     const auto get_neighbors = [this]( const tripoint & pt ) {
@@ -335,10 +384,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
         }
     };
 
-    // This should be true only when the field changes transparency
-    // More correctly: not just when the field is opaque, but when it changes state
-    // to a more/less transparent one, or creates a non-transparent field nearby
-    bool dirty_transparency_cache = false;
     //Holds m.field_at(x,y).find_field(fd_some_field) type returns.
     // Just to avoid typing that long string for a temp value.
     field_entry *tmpfld = nullptr;
@@ -367,8 +412,8 @@ bool map::process_fields_in_submap( submap *const current_submap,
                 field_entry &cur = it->second;
                 // The field might have been killed by processing a neighbor field
                 if( !cur.is_field_alive() ) {
-                    if( !all_field_types_enum_list[cur.get_field_type()].transparent[cur.get_field_intensity() - 1] ) {
-                        dirty_transparency_cache = true;
+                    if( field_type_dangerous( cur.get_field_type() ) ) {
+                        set_pathfinding_cache_dirty( p );
                     }
                     --current_submap->field_count;
                     curfield.remove_field( it++ );
@@ -460,7 +505,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
                     case fd_plasma:
                     case fd_laser:
-                        dirty_transparency_cache = true;
                         break;
 
                     // TODO: MATERIALS use fire resistance
@@ -927,8 +971,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                                 // Create thicker smoke
                                 dst.add_field( fd_smoke, cur.get_field_intensity(), 0_turns );
                             }
-
-                            dirty_transparency_cache = true; // Smoke affects transparency
                         }
 
                         // Hot air is a load on the CPU
@@ -942,17 +984,14 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_smoke:
                     case fd_tear_gas:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 10, 0_turns );
                         break;
 
                     case fd_relax_gas:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 15, 5_minutes );
                         break;
 
                     case fd_fungal_haze:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 13, 5_turns );
                         if( one_in( 10 - 2 * cur.get_field_intensity() ) ) {
                             // Haze'd terrain
@@ -962,17 +1001,14 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
 
                     case fd_toxic_gas:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 30, 3_minutes );
                         break;
 
                     case fd_cigsmoke:
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 250, 6_minutes );
                         break;
 
                     case fd_weedsmoke: {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 200, 6_minutes );
 
                         if( one_in( 20 ) ) {
@@ -985,7 +1021,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     break;
 
                     case fd_methsmoke: {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 175, 7_minutes );
                         if( one_in( 20 ) ) {
                             if( npc *const np = g->critter_at<npc>( p ) ) {
@@ -996,7 +1031,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     break;
 
                     case fd_cracksmoke: {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 175, 8_minutes );
 
                         if( one_in( 20 ) ) {
@@ -1008,7 +1042,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     break;
 
                     case fd_nuke_gas: {
-                        dirty_transparency_cache = true;
                         int extra_radiation = rng( 0, cur.get_field_intensity() );
                         adjust_radiation( p, extra_radiation );
                         spread_gas( cur, p, curtype, 15, 1_minutes );
@@ -1027,7 +1060,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
 
                     case fd_gas_vent: {
-                        dirty_transparency_cache = true;
                         for( const tripoint &pnt : points_in_radius( p, cur.get_field_intensity() - 1 ) ) {
                             field &wandering_field = get_field( pnt );
                             tmpfld = wandering_field.find_field( fd_toxic_gas );
@@ -1041,7 +1073,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     break;
 
                     case fd_smoke_vent: {
-                        dirty_transparency_cache = true;
                         for( const tripoint &pnt : points_in_radius( p, cur.get_field_intensity() - 1 ) ) {
                             field &wandering_field = get_field( pnt );
                             tmpfld = wandering_field.find_field( fd_smoke );
@@ -1061,7 +1092,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                             }
                             create_hot_air( p, cur.get_field_intensity() );
                         } else {
-                            dirty_transparency_cache = true;
                             add_field( p, fd_flame_burst, 3, cur.get_field_age() );
                             cur.set_field_intensity( 0 );
                         }
@@ -1072,7 +1102,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                             cur.set_field_intensity( cur.get_field_intensity() - 1 );
                             create_hot_air( p, cur.get_field_intensity() );
                         } else {
-                            dirty_transparency_cache = true;
                             add_field( p, fd_fire_vent, 3, cur.get_field_age() );
                             cur.set_field_intensity( 0 );
                         }
@@ -1251,7 +1280,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
 
                     case fd_bees:
-                        dirty_transparency_cache = true;
                         // Poor bees are vulnerable to so many other fields.
                         // TODO: maybe adjust effects based on different fields.
                         if( curfield.find_field( fd_web ) ||
@@ -1306,7 +1334,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
 
                     case fd_incendiary: {
                         //Needed for variable scope
-                        dirty_transparency_cache = true;
                         tripoint dst( p.x + rng( -1, 1 ), p.y + rng( -1, 1 ), p.z );
                         if( has_flag( TFLAG_FLAMMABLE, dst ) ||
                             has_flag( TFLAG_FLAMMABLE_ASH, dst ) ||
@@ -1330,7 +1357,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         break;
 
                     case fd_fungicidal_gas: {
-                        dirty_transparency_cache = true;
                         spread_gas( cur, p, curtype, 120, 1_minutes );
                         //check the terrain and replace it accordingly to simulate the fungus dieing off
                         const auto &ter = map_tile.get_ter_t();
@@ -1359,6 +1385,9 @@ bool map::process_fields_in_submap( submap *const current_submap,
                     cur.set_field_intensity( cur.get_field_intensity() - 1 );
                 }
                 if( !cur.is_field_alive() ) {
+                    if( field_type_dangerous( cur.get_field_type() ) ) {
+                        set_pathfinding_cache_dirty( p );
+                    }
                     --current_submap->field_count;
                     curfield.remove_field( it++ );
                 } else {
@@ -1381,7 +1410,6 @@ bool map::process_fields_in_submap( submap *const current_submap,
             }
         }
     }
-    return dirty_transparency_cache;
 }
 
 //This entire function makes very little sense. Why are the rules the way they are? Why does walking into some things destroy them but not others?
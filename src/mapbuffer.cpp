@@ -6,6 +6,7 @@
 #include <functional>
 #include <iterator>
 #include <set>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -18,8 +19,12 @@
 #include "json.h"
 #include "map.h"
 #include "mapdata.h"
+#include "options.h"
 #include "output.h"
+#include "save_writer.h"
 #include "submap.h"
+#include "submap_prefetcher.h"
+#include "submap_region.h"
 #include "translations.h"
 #include "trap.h"
 #include "vehicle.h"
@@ -51,15 +56,28 @@ void mapbuffer::reset()
         delete elem.second;
     }
     submaps.clear();
+    submaps_with_vehicles.clear();
+    regions.clear();
+    if( prefetcher ) {
+        prefetcher->discard();
+    }
 }
 
 bool mapbuffer::add_submap( const tripoint &p, submap *sm )
 {
-    if( submaps.count( p ) != 0 ) {
+    const auto iter = submaps.find( p );
+    if( iter != submaps.end() ) {
+        if( iter->second == sm ) {
+            // map::saven adds its submaps again, a chance to catch up on its vehicles.
+            vehicles_changed( p );
+        }
         return false;
     }
 
     submaps[p] = sm;
+    if( !sm->vehicles.empty() ) {
+        submaps_with_vehicles[p] = sm;
+    }
 
     return true;
 }
@@ -92,6 +110,20 @@ void mapbuffer::remove_submap( tripoint addr )
     }
     delete m_target->second;
     submaps.erase( m_target );
+    submaps_with_vehicles.erase( addr );
+}
+
+void mapbuffer::vehicles_changed( const tripoint &p )
+{
+    const auto iter = submaps.find( p );
+    if( iter == submaps.end() ) {
+        return;
+    }
+    if( iter->second->vehicles.empty() ) {
+        submaps_with_vehicles.erase( p );
+    } else {
+        submaps_with_vehicles[p] = iter->second;
+    }
 }
 
 submap *mapbuffer::lookup_submap( int x, int y, int z )
@@ -106,6 +138,14 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
     const auto iter = submaps.find( p );
     if( iter == submaps.end() ) {
         try {
+            submap_prefetcher::quad prefetched;
+            if( prefetcher && prefetcher->take( sm_to_omt_copy( p ), prefetched ) ) {
+                install_quad( prefetched.quad_file, prefetched.region_records, prefetched.om_addr );
+                const auto installed = submaps.find( p );
+                if( installed != submaps.end() ) {
+                    return installed->second;
+                }
+            }
             return unserialize_submaps( p );
         } catch( const std::exception &err ) {
             debugmsg( "Failed to load submap (%d,%d,%d): %s", p.x, p.y, p.z, err.what() );
@@ -116,8 +156,68 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
     return iter->second;
 }
 
+void mapbuffer::prefetch( const tripoint &p )
+{
+    // While a background save is written, the files may be older than the submaps they hold.
+    if( submaps.count( p ) != 0 || !submap_prefetcher::available() || get_save_writer().busy() ) {
+        return;
+    }
+    if( !prefetcher ) {
+        prefetcher = std::make_unique<submap_prefetcher>();
+    }
+    prefetcher->request( g->get_world_base_save_path() + "/maps", sm_to_omt_copy( p ) );
+}
+
+void mapbuffer::install_prefetched( const int max_quads )
+{
+    if( !prefetcher ) {
+        return;
+    }
+    for( const submap_prefetcher::quad &prefetched : prefetcher->take_finished( max_quads ) ) {
+        try {
+            install_quad( prefetched.quad_file, prefetched.region_records, prefetched.om_addr );
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to load submap quad (%d,%d,%d): %s", prefetched.om_addr.x,
+                      prefetched.om_addr.y, prefetched.om_addr.z, err.what() );
+        }
+    }
+}
+
+void mapbuffer::install_quad( const std::string &quad_file,
+                              const std::map<tripoint, std::string> &region_records,
+                              const tripoint &om_addr )
+{
+    if( !quad_file.empty() ) {
+        const tripoint sm_addr = omt_to_sm_copy( om_addr );
+        for( int x = 0; x < 2; x++ ) {
+            for( int y = 0; y < 2; y++ ) {
+                if( submaps.count( tripoint( sm_addr.x + x, sm_addr.y + y, sm_addr.z ) ) != 0 ) {
+                    // Loaded (and maybe changed) since the file was read.
+                    return;
+                }
+            }
+        }
+        std::istringstream contents( quad_file );
+        JsonIn jsin( contents );
+        deserialize( jsin );
+        return;
+    }
+    for( const auto &elem : region_records ) {
+        if( submaps.count( elem.first ) == 0 ) {
+            std::istringstream record( elem.second );
+            JsonIn jsin( record );
+            deserialize_submap( jsin );
+        }
+    }
+}
+
 void mapbuffer::save( bool delete_after_save )
 {
+    if( prefetcher ) {
+        // Saving changes the files, anything read before is stale.
+        prefetcher->discard();
+    }
+
     std::stringstream map_directory;
     map_directory << g->get_world_base_save_path() << "/maps";
     assure_dir_exist( map_directory.str() );
@@ -127,10 +227,15 @@ void mapbuffer::save( bool delete_after_save )
 
     const tripoint map_origin = sm_to_omt_copy( g->m.get_abs_sub() );
     const bool map_has_zlevels = g != nullptr && g->m.has_zlevels();
+    const bool use_regions = get_option<std::string>( "MAP_SAVE_FORMAT" ) == "regions";
 
     // A set of already-saved submaps, in global overmap coordinates.
     std::set<tripoint> saved_submaps;
     std::list<tripoint> submaps_to_delete;
+    // Records for the region files, by segment.
+    std::map<tripoint, std::map<tripoint, std::string>> region_records;
+    // Quad files superseded by the records above.
+    std::vector<std::string> replaced_quad_files;
     int next_report = 0;
     for( auto &elem : submaps ) {
         if( num_total_submaps > 100 && num_saved_submaps >= next_report ) {
@@ -165,13 +270,30 @@ void mapbuffer::save( bool delete_after_save )
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
         const bool zlev_del = !map_has_zlevels && om_addr.z != g->get_levz();
-        save_quad( dirname.str(), quad_path.str(), om_addr, submaps_to_delete,
-                   delete_after_save || zlev_del ||
-                   om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
-                   om_addr.x > map_origin.x + HALF_MAPSIZE ||
-                   om_addr.y > map_origin.y + HALF_MAPSIZE );
+        const bool delete_quad = delete_after_save || zlev_del ||
+                                 om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
+                                 om_addr.x > map_origin.x + HALF_MAPSIZE ||
+                                 om_addr.y > map_origin.y + HALF_MAPSIZE;
+        if( use_regions ) {
+            std::map<tripoint, std::string> &records = region_records[segment_addr];
+            const size_t num_records = records.size();
+            save_quad( dirname.str(), quad_path.str(), om_addr, submaps_to_delete, delete_quad,
+                       &records );
+            // The quad file would take precedence over the new records when loading.
+            if( records.size() != num_records && file_exist( quad_path.str() ) ) {
+                replaced_quad_files.push_back( quad_path.str() );
+            }
+        } else {
+            save_quad( dirname.str(), quad_path.str(), om_addr, submaps_to_delete, delete_quad );
+        }
         num_saved_submaps += 4;
     }
+    for( auto &elem : region_records ) {
+        save_region( map_directory.str(), elem.first, elem.second );
+    }
+    for( const std::string &path : replaced_quad_files ) {
+        remove_save_file( path );
+    }
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
@@ -179,7 +301,7 @@ void mapbuffer::save( bool delete_after_save )
 
 void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
                            const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+                           bool delete_after_save, std::map<tripoint, std::string> *region_records )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -194,6 +316,11 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         submap_addr.x += offsets_offset.x;
         submap_addr.y += offsets_offset.y;
         submap_addrs.push_back( submap_addr );
+        if( region_records == nullptr && submaps.count( submap_addr ) == 0 ) {
+            // Submaps from region files are loaded one at a time, but a quad file
+            // has to contain the whole quad.
+            unserialize_from_region( submap_addr );
+        }
         submap *sm = submaps[submap_addr];
         if( sm != nullptr && !sm->is_uniform ) {
             all_uniform = false;
@@ -213,44 +340,110 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         return;
     }
 
+    if( region_records != nullptr ) {
+        for( auto &submap_addr : submap_addrs ) {
+            submap *sm = submaps[submap_addr];
+            if( sm == nullptr ) {
+                continue;
+            }
+            std::ostringstream record;
+            JsonOut jsout( record );
+            serialize_submap( jsout, submap_addr, *sm );
+            ( *region_records )[submap_addr] = record.str();
+            if( delete_after_save ) {
+                submaps_to_delete.push_back( submap_addr );
+            }
+        }
+        return;
+    }
+
     // Don't create the directory if it would be empty
     assure_dir_exist( dirname );
-    ofstream_wrapper_exclusive fout( filename );
-    JsonOut jsout( fout );
-    jsout.start_array();
-    for( auto &submap_addr : submap_addrs ) {
-        if( submaps.count( submap_addr ) == 0 ) {
-            continue;
-        }
+    write_save_file( filename, [&]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_array();
+        for( auto &submap_addr : submap_addrs ) {
+            if( submaps.count( submap_addr ) == 0 ) {
+                continue;
+            }
 
-        submap *sm = submaps[submap_addr];
+            submap *sm = submaps[submap_addr];
 
-        if( sm == nullptr ) {
-            continue;
-        }
+            if( sm == nullptr ) {
+                continue;
+            }
 
-        jsout.start_object();
+            serialize_submap( jsout, submap_addr, *sm );
 
-        jsout.member( "version", savegame_version );
-        jsout.member( "coordinates" );
+            if( delete_after_save ) {
+                submaps_to_delete.push_back( submap_addr );
+            }
+        }
 
-        jsout.start_array();
-        jsout.write( submap_addr.x );
-        jsout.write( submap_addr.y );
-        jsout.write( submap_addr.z );
         jsout.end_array();
+    }, true );
+}
 
-        sm->store( jsout );
+void mapbuffer::serialize_submap( JsonOut &jsout, const tripoint &submap_addr, submap &sm )
+{
+    jsout.start_object();
 
-        jsout.end_object();
+    jsout.member( "version", savegame_version );
+    jsout.member( "coordinates" );
 
-        if( delete_after_save ) {
-            submaps_to_delete.push_back( submap_addr );
+    jsout.start_array();
+    jsout.write( submap_addr.x );
+    jsout.write( submap_addr.y );
+    jsout.write( submap_addr.z );
+    jsout.end_array();
+
+    sm.store( jsout );
+
+    jsout.end_object();
+}
+
+void mapbuffer::save_region( const std::string &map_directory, const tripoint &segment_addr,
+                             std::map<tripoint, std::string> &records )
+{
+    const submap_region *region = get_region( segment_addr );
+    if( region != nullptr ) {
+        // Only the records that changed since the file was written need to be saved.
+        for( auto iter = records.begin(); iter != records.end(); ) {
+            if( region->has_record( iter->first, iter->second ) ) {
+                iter = records.erase( iter );
+            } else {
+                ++iter;
+            }
         }
     }
-
-    jsout.end_array();
-    fout.close();
+    if( records.empty() ) {
+        return;
+    }
+    // A file that could not be opened is replaced.
+    const bool append = region != nullptr;
+    // Unmap the old file before it gets changed.
+    regions.erase( segment_addr );
+    const std::string path = submap_region::path_for( map_directory, segment_addr );
+    save_writer &writer = get_save_writer();
+    if( writer.is_collecting() ) {
+        if( append ) {
+            writer.update( path, [records]( const std::string & region_path ) {
+                submap_region::append( region_path, records );
+            } );
+        } else {
+            std::ostringstream contents;
+            submap_region::write( contents, records );
+            writer.write( path, contents.str() );
+        }
+        return;
+    }
+    writer.wait();
+    writer.forget( path );
+    if( append ) {
+        submap_region::append( path, records );
+    } else {
+        submap_region::write( path, records );
+    }
 }
 
 // We're reading in way too many entities here to mess around with creating sub-objects and
@@ -265,11 +458,13 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
               segment_addr.x << "." << segment_addr.y << "." << segment_addr.z << "/" <<
               om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
 
+    // The file may still be written by a background save.
+    get_save_writer().wait();
     using namespace std::placeholders;
     if( !read_from_file_optional_json( quad_path.str(),
                                        std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
-        // If it doesn't exist, trigger generating it.
-        return nullptr;
+        // If it isn't in a region file either, trigger generating it.
+        return unserialize_from_region( p );
     }
     if( submaps.count( p ) == 0 ) {
         debugmsg( "file %s did not contain the expected submap %d,%d,%d",
@@ -279,35 +474,79 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     return submaps[ p ];
 }
 
+submap *mapbuffer::unserialize_from_region( const tripoint &p )
+{
+    const tripoint segment_addr = omt_to_seg_copy( sm_to_omt_copy( p ) );
+    const submap_region *region = get_region( segment_addr );
+    if( region == nullptr || !region->has( p ) ) {
+        return nullptr;
+    }
+    std::istringstream record( region->record( p ) );
+    JsonIn jsin( record );
+    deserialize_submap( jsin );
+    if( submaps.count( p ) == 0 ) {
+        debugmsg( "region record of submap %d,%d,%d has different coordinates", p.x, p.y, p.z );
+        return nullptr;
+    }
+    return submaps[ p ];
+}
+
+submap_region *mapbuffer::get_region( const tripoint &segment_addr )
+{
+    const auto iter = regions.find( segment_addr );
+    if( iter != regions.end() ) {
+        return iter->second.get();
+    }
+    const std::string path = submap_region::path_for( g->get_world_base_save_path() + "/maps",
+                             segment_addr );
+    // The file may still be written by a background save.
+    get_save_writer().wait();
+    std::unique_ptr<submap_region> &region = regions[segment_addr];
+    if( file_exist( path ) ) {
+        try {
+            region = std::make_unique<submap_region>( path );
+        } catch( const std::runtime_error &err ) {
+            debugmsg( "Failed to load map region (%d,%d,%d): %s", segment_addr.x, segment_addr.y,
+                      segment_addr.z, err.what() );
+        }
+    }
+    return region.get();
+}
+
 void mapbuffer::deserialize( JsonIn &jsin )
 {
     jsin.start_array();
     while( !jsin.end_array() ) {
-        std::unique_ptr<submap> sm = std::make_unique<submap>();
-        tripoint submap_coordinates;
-        jsin.start_object();
-        bool rubpow_update = false;
-        while( !jsin.end_object() ) {
-            std::string submap_member_name = jsin.get_member_name();
-            if( submap_member_name == "version" ) {
-                if( jsin.get_int() < 22 ) {
-                    rubpow_update = true;
-                }
-            } else if( submap_member_name == "coordinates" ) {
-                jsin.start_array();
-                int locx = jsin.get_int();
-                int locy = jsin.get_int();
-                int locz = jsin.get_int();
-                jsin.end_array();
-                submap_coordinates = tripoint( locx, locy, locz );
-            } else {
-                sm->load( jsin, submap_member_name, rubpow_update );
+        deserialize_submap( jsin );
+    }
+}
+
+void mapbuffer::deserialize_submap( JsonIn &jsin )
+{
+    std::unique_ptr<submap> sm = std::make_unique<submap>();
+    tripoint submap_coordinates;
+    jsin.start_object();
+    bool rubpow_update = false;
+    while( !jsin.end_object() ) {
+        std::string submap_member_name = jsin.get_member_name();
+        if( submap_member_name == "version" ) {
+            if( jsin.get_int() < 22 ) {
+                rubpow_update = true;
             }
+        } else if( submap_member_name == "coordinates" ) {
+            jsin.start_array();
+            int locx = jsin.get_int();
+            int locy = jsin.get_int();
+            int locz = jsin.get_int();
+            jsin.end_array();
+            submap_coordinates = tripoint( locx, locy, locz );
+        } else {
+            sm->load( jsin, submap_member_name, rubpow_update );
         }
+    }
 
-        if( !add_submap( submap_coordinates, sm ) ) {
-            debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
-                      submap_coordinates.z );
-        }
+    if( !add_submap( submap_coordinates, sm ) ) {
+        debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
+                  submap_coordinates.z );
     }
 }
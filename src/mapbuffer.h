@@ -11,7 +11,10 @@
 #include "point.h"
 
 class submap;
+class submap_prefetcher;
+class submap_region;
 class JsonIn;
+class JsonOut;
 
 /**
  * Store, buffer, save and load the entire world map.
@@ -58,6 +61,18 @@ class mapbuffer
         submap *lookup_submap( int x, int y, int z );
         submap *lookup_submap( const tripoint &p );
 
+        /**
+         * Starts reading the saved quad of the submap at @p p in the background, unless
+         * it is already loaded. Submaps that have never been generated are left to mapgen
+         * in @ref map::loadn, which has to run on the main thread.
+         */
+        void prefetch( const tripoint &p );
+        /**
+         * Decodes up to @p max_quads quads that have been read in the background into
+         * this buffer, so looking them up later doesn't need to touch the disk.
+         */
+        void install_prefetched( int max_quads );
+
     private:
         using submap_map_t = std::map<tripoint, submap *>;
 
@@ -69,16 +84,58 @@ class mapbuffer
             return submaps.end();
         }
 
+        /**
+         * Buffered submaps that hold vehicles, by position. Lets per-turn vehicle processing
+         * skip the (possibly thousands of) submaps without any.
+         */
+        const submap_map_t &get_submaps_with_vehicles() const {
+            return submaps_with_vehicles;
+        }
+        /**
+         * Updates @ref get_submaps_with_vehicles after vehicles have been added to or removed
+         * from the submap at @p p. Submaps that aren't buffered yet are registered by
+         * @ref add_submap instead.
+         */
+        void vehicles_changed( const tripoint &p );
+
     private:
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
+        /**
+         * Decodes the submaps of the quad @p om_addr from its prefetched quad file or region
+         * records, unless any of them has been loaded since it was read.
+         */
+        void install_quad( const std::string &quad_file,
+                           const std::map<tripoint, std::string> &region_records,
+                           const tripoint &om_addr );
         submap *unserialize_submaps( const tripoint &p );
+        /** Loads the submap at @p p from the region file of its segment, if that has it. */
+        submap *unserialize_from_region( const tripoint &p );
+        /** The region file of the segment @p segment_addr, nullptr if there is none. */
+        submap_region *get_region( const tripoint &segment_addr );
         void deserialize( JsonIn &jsin );
+        void deserialize_submap( JsonIn &jsin );
+        void serialize_submap( JsonOut &jsout, const tripoint &submap_addr, submap &sm );
+        /**
+         * Saves the quad at @p om_addr into the quad file @p filename, or, if @p region_records
+         * is not null, adds the records of its submaps to it for the region file.
+         */
         void save_quad( const std::string &dirname, const std::string &filename,
                         const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+                        bool delete_after_save,
+                        std::map<tripoint, std::string> *region_records = nullptr );
+        /**
+         * Merges @p records into the region file of @p segment_addr. Records the file already
+         * has are removed from @p records, the changed ones are appended to the file.
+         */
+        void save_region( const std::string &map_directory, const tripoint &segment_addr,
+                          std::map<tripoint, std::string> &records );
         submap_map_t submaps;
+        submap_map_t submaps_with_vehicles;
+        // Opened region files by segment, nullptr for segments without one.
+        std::map<tripoint, std::unique_ptr<submap_region>> regions;
+        std::unique_ptr<submap_prefetcher> prefetcher;
 };
 
 extern mapbuffer MAPBUFFER;
@@ -30,6 +30,7 @@
 #include "map.h"
 #include "map_extras.h"
 #include "map_iterator.h"
+#include "mapbuffer.h"
 #include "mapdata.h"
 #include "mapgen_functions.h"
 #include "mapgenformat.h"
@@ -2226,8 +2227,8 @@ void mapgen_function_json_base::setup_common()
     if( is_ready ) {
         return;
     }
-    std::istringstream iss( jdata );
-    JsonIn jsin( iss );
+    JsonBuffer buffer( jdata.data(), jdata.size() );
+    JsonIn jsin( buffer );
     JsonObject jo = jsin.get_object();
     mapgen_defer::defer = false;
     if( !setup_common( jo ) ) {
@@ -7109,6 +7110,9 @@ vehicle *map::add_vehicle( const vproto_id &type, const tripoint &p, const int d
         submap *place_on_submap = get_submap_at_grid( { placed_vehicle->smx, placed_vehicle->smy, placed_vehicle->smz} );
         place_on_submap->vehicles.push_back( std::move( placed_vehicle_up ) );
         place_on_submap->is_uniform = false;
+        MAPBUFFER.vehicles_changed( tripoint( abs_sub.x + placed_vehicle->smx,
+                                              abs_sub.y + placed_vehicle->smy,
+                                              placed_vehicle->smz ) );
 
         auto &ch = get_cache( placed_vehicle->smz );
         ch.vehicle_list.insert( placed_vehicle );
@@ -7,9 +7,11 @@
 #include <algorithm>
 #include <memory>
 #include <ostream>
+#include <set>
 
 #include "avatar.h"
 #include "bionics.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "field.h"
 #include "game.h"
@@ -216,7 +218,7 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
     return INT_MAX;
 }
 
-void monster::plan( const mfactions &factions )
+void monster::plan()
 {
     // Bots are more intelligent than most living stuff
     bool smart_planning = has_flag( MF_PRIORITIZE_TARGETS );
@@ -236,6 +238,11 @@ void monster::plan( const mfactions &factions )
     bool group_morale = has_flag( MF_GROUP_MORALE ) && morale < type->morale;
     bool swarms = has_flag( MF_SWARMS );
     auto mood = attitude();
+    const mfaction_id player_faction = mfaction_str_id( "player" ).id();
+    // Monsters further away than this can't be seen, see Creature::sees.
+    const int sight_radius = std::max( { 1, sight_range( DAYLIGHT_LEVEL ), sight_range( 0 ) } );
+    const std::vector<monster *> nearby = g->critter_tracker->find_all_in_radius( pos(),
+                                          sight_radius );
 
     // If we can see the player, move toward them or flee, simpleminded animals are too dumb to follow the player.
     if( friendly == 0 && sees( g->u ) && !has_flag( MF_PET_WONT_FOLLOW ) ) {
@@ -276,7 +283,12 @@ void monster::plan( const mfactions &factions )
             }
         }
     } else if( friendly != 0 && !docile ) {
-        for( monster &tmp : all_monsters ) {
+        for( monster *const tmp_ptr : nearby ) {
+            monster &tmp = *tmp_ptr;
+            if( !smart_planning && rl_dist( pos(), tmp.pos() ) >= dist ) {
+                // Sorted by distance, nothing that follows can be rated better.
+                break;
+            }
             if( tmp.friendly == 0 ) {
                 float rating = rate_target( tmp, dist, smart_planning );
                 if( rating < dist ) {
@@ -335,42 +347,41 @@ void monster::plan( const mfactions &factions )
 
     fleeing = fleeing || ( mood == MATT_FLEE );
     if( friendly == 0 ) {
-        for( const auto &fac : factions ) {
-            auto faction_att = faction.obj().attitude( fac.first );
+        for( monster *const mon_ptr : nearby ) {
+            monster &mon = *mon_ptr;
+            if( !smart_planning && rl_dist( pos(), mon.pos() ) >= dist ) {
+                // Sorted by distance, nothing that follows can be rated better.
+                break;
+            }
+            // Friendly monsters count as the player's faction.
+            auto faction_att = faction.obj().attitude( mon.friendly == 0 ? mon.faction :
+                               player_faction );
             if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
                 continue;
             }
 
-            for( monster *const mon_ptr : fac.second ) {
-                monster &mon = *mon_ptr;
-                float rating = rate_target( mon, dist, smart_planning );
-                if( rating < dist ) {
-                    target = &mon;
-                    dist = rating;
-                }
-                if( rating <= 5 ) {
-                    anger += angers_hostile_near;
-                    morale -= fears_hostile_near;
-                }
+            float rating = rate_target( mon, dist, smart_planning );
+            if( rating < dist ) {
+                target = &mon;
+                dist = rating;
+            }
+            if( rating <= 5 ) {
+                anger += angers_hostile_near;
+                morale -= fears_hostile_near;
             }
         }
     }
 
     // Friendly monsters here
     // Avoid for hordes of same-faction stuff or it could get expensive
-    const auto actual_faction = friendly == 0 ? faction : mfaction_str_id( "player" );
-    const auto &myfaction_iter = factions.find( actual_faction );
-    if( myfaction_iter == factions.end() ) {
-        DebugLog( D_ERROR, D_GAME ) << disp_name() << " tried to find faction "
-                                    << actual_faction.id().str()
-                                    << " which wasn't loaded in game::monmove";
-        swarms = false;
-        group_morale = false;
-    }
+    const mfaction_id actual_faction = friendly == 0 ? faction : player_faction;
     swarms = swarms && target == nullptr; // Only swarm if we have no target
     if( group_morale || swarms ) {
-        for( monster *const mon_ptr : myfaction_iter->second ) {
+        for( monster *const mon_ptr : nearby ) {
             monster &mon = *mon_ptr;
+            if( ( mon.friendly == 0 ? mon.faction : player_faction ) != actual_faction ) {
+                continue;
+            }
             float rating = rate_target( mon, dist, smart_planning );
             if( group_morale && rating <= 10 ) {
                 morale += 10 - rating;
@@ -701,7 +712,11 @@ void monster::move()
         if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
             ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
             // We need a new path
-            path = g->m.route( pos(), goal, pf_settings, get_path_avoid() );
+            // Monsters chasing the same target share a flow field instead of pathing on their own
+            const std::set<tripoint> path_avoid = get_path_avoid();
+            if( !path_avoid.empty() || !g->m.route_from_flow_field( pos(), goal, pf_settings, path ) ) {
+                path = g->m.route( pos(), goal, pf_settings, path_avoid );
+            }
         }
 
         // Try to respect old paths, even if we can't pathfind at the moment
@@ -41,8 +41,6 @@ enum field_id : int;
 
 class monster;
 
-using mfactions = std::map< mfaction_id, std::set< monster * > >;
-
 class mon_special_attack
 {
     public:
@@ -192,9 +190,9 @@ class monster : public Creature
 
         // How good of a target is given creature (checks for visibility)
         float rate_target( Creature &c, float best, bool smart = false ) const;
-        // Pass all factions to mon, so that hordes of same-faction mons
-        // do not iterate over each other
-        void plan( const mfactions &factions );
+        // Picks a target among the creatures nearby, using the creature tracker's
+        // spatial index so hordes do not iterate over each other
+        void plan();
         void move(); // Actual movement
         void footsteps( const tripoint &p ); // noise made by movement
         void shove_vehicle( const tripoint &remote_destination,
@@ -110,6 +110,7 @@ void Character::set_mutation( const trait_id &flag )
     }
     recalc_sight_limits();
     reset_encumbrance();
+    on_mutations_changed();
 }
 
 void Character::unset_mutation( const trait_id &flag )
@@ -125,6 +126,7 @@ void Character::unset_mutation( const trait_id &flag )
     }
     recalc_sight_limits();
     reset_encumbrance();
+    on_mutations_changed();
 }
 
 int Character::get_mod( const trait_id &mut, const std::string &arg ) const
@@ -15,6 +15,7 @@
 #include "bionics.h"
 #include "cata_algo.h"
 #include "clzones.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "dispersion.h"
 #include "effect.h"
@@ -120,6 +121,8 @@ const bionic_id bio_laser( "bio_laser" );
 const bionic_id bio_blade( "bio_blade" );
 const bionic_id bio_claws( "bio_claws" );
 
+const bionic_id bio_ground_sonar( "bio_ground_sonar" );
+
 const ammotype reactor_slurry( "reactor_slurry" );
 const ammotype plutonium( "plutonium" );
 
@@ -434,7 +437,16 @@ void npc::assess_danger()
         }
     }
 
-    for( const monster &critter : g->all_monsters() ) {
+    // Monsters further away can't be seen, see Creature::sees and player::sees. Ground sonar
+    // has no range limit.
+    const int sight_radius = has_active_bionic( bio_ground_sonar ) ?
+                             2 * std::max( MAPSIZE_X, MAPSIZE_Y ) :
+                             std::max( { 3, sight_range( DAYLIGHT_LEVEL ), sight_range( 0 ),
+                                         clairvoyance()
+                                       } );
+    for( const monster *const critter_ptr : g->critter_tracker->find_all_in_radius( pos(),
+            sight_radius ) ) {
+        const monster &critter = *critter_ptr;
         if( !sees( critter ) ) {
             continue;
         }
@@ -17,6 +17,7 @@
 #include "path_info.h"
 #include "sdlsound.h"
 #include "sdltiles.h"
+#include "shadowcasting.h"
 #include "sounds.h"
 #include "string_formatter.h"
 #include "string_input_popup.h"
@@ -47,6 +48,7 @@ bool log_from_top;
 int message_ttl;
 int message_cooldown;
 bool fov_3d;
+bool parallel_shadowcasting;
 bool tile_iso;
 
 std::map<std::string, std::string> TILESETS; // All found tilesets: <name, tileset_dir>
@@ -1176,6 +1178,13 @@ void options_manager::add_options_general()
 
     get_option( "AUTOSAVE_MINUTES" ).setPrerequisite( "AUTOSAVE" );
 
+    add( "AUTOSAVE_BACKGROUND", "general", translate_marker( "Autosave in the background" ),
+         translate_marker( "If true, autosaves write the save files while the game continues.  Only gathering the data to save pauses the game." ),
+         true
+       );
+
+    get_option( "AUTOSAVE_BACKGROUND" ).setPrerequisite( "AUTOSAVE" );
+
     mOptionsSort["general"]++;
 
     add( "AUTO_NOTES", "general", translate_marker( "Auto notes" ),
@@ -1848,6 +1857,11 @@ void options_manager::add_options_debug()
          false
        );
 
+    add( "PARALLEL_SHADOWCASTING", "debug", translate_marker( "Parallel shadowcasting" ),
+         translate_marker( "If true, vision and light are calculated on all processor cores.  Turn this off to keep the game on a single core." ),
+         true
+       );
+
     add( "ENCODING_CONV", "debug", translate_marker( "Experimental path name encoding conversion" ),
          translate_marker( "If true, file path names are going to be transcoded from system encoding to UTF-8 when reading and will be transcoded back when writing.  Mainly for CJK Windows users." ),
          true
@@ -2015,6 +2029,14 @@ void options_manager::add_options_world_default()
 
     mOptionsSort["world_default"]++;
 
+    add( "MAP_SAVE_FORMAT", "world_default", translate_marker( "Map save format" ),
+         translate_marker( "How the map of the world is saved.  Quad files store every 2x2 submap quad in its own JSON file.  Region files store the submaps of 32x32 quads in one file, which saves and loads faster on large worlds.  Use the --convert-maps command line option to convert the maps of an existing world." ),
+    { { "quads", translate_marker( "Quad files" ) }, { "regions", translate_marker( "Region files" ) } },
+    "quads"
+       );
+
+    mOptionsSort["world_default"]++;
+
     add( "CHARACTER_POINT_POOLS", "world_default", translate_marker( "Character point pools" ),
          translate_marker( "Allowed point pools for character generation." ),
     { { "any", translate_marker( "Any" ) }, { "multi_pool", translate_marker( "Multi-pool only" ) }, { "no_freeform", translate_marker( "No freeform" ) } },
@@ -2784,6 +2806,7 @@ bool options_manager::save()
     message_ttl = ::get_option<int>( "MESSAGE_TTL" );
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d = ::get_option<bool>( "FOV_3D" );
+    parallel_shadowcasting = ::get_option<bool>( "PARALLEL_SHADOWCASTING" );
 
     update_music_volume();
 
@@ -2814,6 +2837,7 @@ void options_manager::load()
     message_ttl = ::get_option<int>( "MESSAGE_TTL" );
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d = ::get_option<bool>( "FOV_3D" );
+    parallel_shadowcasting = ::get_option<bool>( "PARALLEL_SHADOWCASTING" );
 #if defined(SDL_SOUND)
     sounds::sound_enabled = ::get_option<bool>( "SOUND_ENABLED" );
 #endif
@@ -45,6 +45,7 @@
 #include "regional_settings.h"
 #include "rng.h"
 #include "rotatable_symbols.h"
+#include "save_writer.h"
 #include "simple_pathfinding.h"
 #include "translations.h"
 #include "assign.h"
@@ -4290,13 +4291,12 @@ void overmap::save() const
     const std::string plrfilename = overmapbuffer::player_filename( loc.x, loc.y );
     const std::string terfilename = overmapbuffer::terrain_filename( loc.x, loc.y );
 
-    ofstream_wrapper fout_player( plrfilename );
-    serialize_view( fout_player );
-    fout_player.close();
-
-    ofstream_wrapper_exclusive fout_terrain( terfilename );
-    serialize( fout_terrain );
-    fout_terrain.close();
+    write_save_file( plrfilename, [&]( std::ostream & fout ) {
+        serialize_view( fout );
+    }, false );
+    write_save_file( terfilename, [&]( std::ostream & fout ) {
+        serialize( fout );
+    }, true );
 }
 
 void overmap::add_mon_group( const mongroup &group )
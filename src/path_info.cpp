@@ -116,6 +116,7 @@ void PATH_INFO::update_config_dir()
     update_pathname( "custom_colors", FILENAMES["config_dir"] + "custom_colors.json" );
     update_pathname( "mods-user-default", FILENAMES["config_dir"] + "user-default-mods.json" );
     update_pathname( "lastworld", FILENAMES["config_dir"] + "lastworld.json" );
+    update_pathname( "verified_data", FILENAMES["config_dir"] + "verified_data.txt" );
 }
 
 void PATH_INFO::set_standard_filenames()
@@ -197,6 +198,7 @@ void PATH_INFO::set_standard_filenames()
     update_pathname( "custom_colors", FILENAMES["config_dir"] + "custom_colors.json" );
     update_pathname( "mods-user-default", FILENAMES["config_dir"] + "user-default-mods.json" );
     update_pathname( "lastworld", FILENAMES["config_dir"] + "lastworld.json" );
+    update_pathname( "verified_data", FILENAMES["config_dir"] + "verified_data.txt" );
     update_pathname( "user_moddir", FILENAMES["user_dir"] + "mods/" );
     update_pathname( "worldoptions", "worldoptions.json" );
 
@@ -6,10 +6,12 @@
 #include <queue>
 #include <set>
 #include <array>
+#include <bitset>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
@@ -37,6 +39,12 @@ constexpr int flat_index( const int x, const int y )
     return ( x * MAPSIZE_Y ) + y;
 }
 
+// Index of the submap-sized cluster in the abstract pathfinding graph
+constexpr int cluster_index( const int smx, const int smy )
+{
+    return smx + smy * MAPSIZE;
+}
+
 // Flattened 2D array representing a single z-level worth of pathfinding data
 struct path_data_layer {
     // State is accessed way more often than all other values here
@@ -53,6 +61,19 @@ struct path_data_layer {
             }
         }
     }
+
+    // Only the tiles of the submap-sized clusters set in `corridor` (indexed by
+    // smx + smy * MAPSIZE), the search never looks at any other tile
+    void init( const std::bitset<MAPSIZE * MAPSIZE> &corridor ) {
+        for( size_t i = 0; i < corridor.size(); i++ ) {
+            if( !corridor[i] ) {
+                continue;
+            }
+            const int minx = static_cast<int>( i % MAPSIZE ) * SEEX;
+            const int miny = static_cast<int>( i / MAPSIZE ) * SEEY;
+            init( minx, miny, minx + SEEX - 1, miny + SEEY - 1 );
+        }
+    }
 };
 
 struct pathfinder {
@@ -60,8 +81,10 @@ struct pathfinder {
     int miny;
     int maxx;
     int maxy;
-    pathfinder( int _minx, int _miny, int _maxx, int _maxy ) :
-        minx( _minx ), miny( _miny ), maxx( _maxx ), maxy( _maxy ) {
+    const std::bitset<MAPSIZE * MAPSIZE> *corridor;
+    pathfinder( int _minx, int _miny, int _maxx, int _maxy,
+                const std::bitset<MAPSIZE * MAPSIZE> *_corridor = nullptr ) :
+        minx( _minx ), miny( _miny ), maxx( _maxx ), maxy( _maxy ), corridor( _corridor ) {
     }
 
     std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
@@ -75,7 +98,11 @@ struct pathfinder {
         }
 
         ptr = std::make_unique<path_data_layer>();
-        ptr->init( minx, miny, maxx, maxy );
+        if( corridor != nullptr ) {
+            ptr->init( *corridor );
+        } else {
+            ptr->init( minx, miny, maxx, maxy );
+        }
         return *ptr;
     }
 
@@ -90,6 +117,9 @@ struct pathfinder {
     }
 
     void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
+        if( corridor != nullptr && !( *corridor )[cluster_index( to.x / SEEX, to.y / SEEY )] ) {
+            return;
+        }
         auto &layer = get_layer( to.z );
         const int index = flat_index( to.x, to.y );
         if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
@@ -149,6 +179,267 @@ bool vertical_move_destination( const map &m, tripoint &t )
     return false;
 }
 
+// Tiles that need more than a simple cost of 2 to walk on
+constexpr pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP;
+
+// Special results of map::pathfinding_step_cost
+// Tile can't be entered from any side
+constexpr int pf_step_closed = -1;
+// Tile can't be entered from this side
+constexpr int pf_step_blocked = -2;
+// Tile is a ledge, the path continues one z-level below instead
+constexpr int pf_step_ledge = -3;
+
+// Flow fields are only built for targets requested at least that many times per turn
+constexpr int flow_field_min_requests = 2;
+// Flow fields kept per z-level, least recently requested ones are dropped first
+constexpr size_t max_flow_fields = 8;
+
+// Routes shorter than that are searched directly, without the abstract graph
+constexpr int hierarchical_route_min_dist = SEEX;
+// Border runs of passable tiles longer than that get an entrance at each end
+constexpr int cluster_long_entrance = 6;
+
+static int cluster_tile_cost( const pf_special special )
+{
+    if( special & PF_WALL ) {
+        return -1;
+    }
+    return ( special & PF_SLOW ) ? 4 : 2;
+}
+
+// Dijkstra limited to a single cluster, using the cheap estimates from pathfinding_cache
+// `dist` is indexed by local position in the cluster, -1 for unreachable tiles
+static void cluster_distances( const pathfinding_cache &cache, const int smx, const int smy,
+                               const point &from, std::array<int, SEEX * SEEY> &dist )
+{
+    dist.fill( -1 );
+    const int minx = smx * SEEX;
+    const int miny = smy * SEEY;
+    std::priority_queue< std::pair<int, point>, std::vector< std::pair<int, point> >, pair_greater_cmp_first >
+    open;
+    dist[( from.x - minx ) * SEEY + from.y - miny] = 0;
+    open.emplace( 0, from );
+    while( !open.empty() ) {
+        const std::pair<int, point> cur = open.top();
+        open.pop();
+        if( cur.first > dist[( cur.second.x - minx ) * SEEY + cur.second.y - miny] ) {
+            continue;
+        }
+        for( int dx = -1; dx <= 1; dx++ ) {
+            for( int dy = -1; dy <= 1; dy++ ) {
+                const point p( cur.second.x + dx, cur.second.y + dy );
+                if( ( dx == 0 && dy == 0 ) || p.x < minx || p.x >= minx + SEEX ||
+                    p.y < miny || p.y >= miny + SEEY ) {
+                    continue;
+                }
+                const int cost = cluster_tile_cost( cache.special[p.x][p.y] );
+                if( cost < 0 ) {
+                    continue;
+                }
+                // Same diagonal penalty as in map::route
+                const int newdist = cur.first + cost + ( ( dx != 0 && dy != 0 ) ? 1 : 0 );
+                int &old = dist[( p.x - minx ) * SEEY + p.y - miny];
+                if( old < 0 || newdist < old ) {
+                    old = newdist;
+                    open.emplace( newdist, p );
+                }
+            }
+        }
+    }
+}
+
+// Adds entrances on the border between cluster ( smx, smy ) and its neighbor in direction ( dx, dy )
+// Runs are computed from both sides the same way, so that every entrance has a partner
+static void add_border_entrances( const pathfinding_cache &cache, const int smx, const int smy,
+                                  const int dx, const int dy, pathfinding_cluster &cluster )
+{
+    // First tile of the border on our side and the step along it
+    const point start( dx > 0 ? ( smx + 1 ) * SEEX - 1 : smx * SEEX,
+                       dy > 0 ? ( smy + 1 ) * SEEY - 1 : smy * SEEY );
+    const point step( dx == 0 ? 1 : 0, dy == 0 ? 1 : 0 );
+    const int length = dx == 0 ? SEEX : SEEY;
+
+    const auto add_entrance = [&]( const int i ) {
+        const point pos( start.x + step.x * i, start.y + step.y * i );
+        cluster.entrances.push_back( { pos, point( pos.x + dx, pos.y + dy ) } );
+    };
+
+    int run_start = -1;
+    for( int i = 0; i <= length; i++ ) {
+        bool open = false;
+        if( i < length ) {
+            const point here( start.x + step.x * i, start.y + step.y * i );
+            open = !( cache.special[here.x][here.y] & PF_WALL ) &&
+                   !( cache.special[here.x + dx][here.y + dy] & PF_WALL );
+        }
+        if( open && run_start < 0 ) {
+            run_start = i;
+        } else if( !open && run_start >= 0 ) {
+            const int run_length = i - run_start;
+            if( run_length >= cluster_long_entrance ) {
+                add_entrance( run_start );
+                add_entrance( i - 1 );
+            } else {
+                add_entrance( run_start + run_length / 2 );
+            }
+            run_start = -1;
+        }
+    }
+}
+
+static void update_cluster( pathfinding_cache &cache, const int smx, const int smy,
+                            const int mapsize )
+{
+    pathfinding_cluster &cluster = cache.clusters[cluster_index( smx, smy )];
+    cluster.entrances.clear();
+    if( smx > 0 ) {
+        add_border_entrances( cache, smx, smy, -1, 0, cluster );
+    }
+    if( smx + 1 < mapsize ) {
+        add_border_entrances( cache, smx, smy, 1, 0, cluster );
+    }
+    if( smy > 0 ) {
+        add_border_entrances( cache, smx, smy, 0, -1, cluster );
+    }
+    if( smy + 1 < mapsize ) {
+        add_border_entrances( cache, smx, smy, 0, 1, cluster );
+    }
+
+    const size_t count = cluster.entrances.size();
+    cluster.costs.assign( count * count, -1 );
+    std::array<int, SEEX * SEEY> dist;
+    for( size_t i = 0; i < count; i++ ) {
+        cluster_distances( cache, smx, smy, cluster.entrances[i].pos, dist );
+        for( size_t j = 0; j < count; j++ ) {
+            const point &to = cluster.entrances[j].pos;
+            cluster.costs[i * count + j] = dist[( to.x - smx * SEEX ) * SEEY + to.y - smy * SEEY];
+        }
+    }
+}
+
+static void update_clusters( pathfinding_cache &cache, const int mapsize )
+{
+    if( cache.dirty_clusters.none() ) {
+        return;
+    }
+    for( int smx = 0; smx < mapsize; smx++ ) {
+        for( int smy = 0; smy < mapsize; smy++ ) {
+            if( cache.dirty_clusters[cluster_index( smx, smy )] ) {
+                update_cluster( cache, smx, smy, mapsize );
+            }
+        }
+    }
+    cache.dirty_clusters.reset();
+}
+
+// A* over the abstract graph of clusters. On success, sets the clusters the abstract path
+// passes through in `corridor`.
+static bool find_cluster_corridor( pathfinding_cache &cache, const int mapsize,
+                                   const point &from, const point &to,
+                                   std::bitset<MAPSIZE * MAPSIZE> &corridor )
+{
+    update_clusters( cache, mapsize );
+
+    // Nodes are encoded as cluster index * max_entrances + entrance index
+    constexpr int max_entrances = 4 * SEEX;
+    constexpr int node_count = MAPSIZE * MAPSIZE * max_entrances;
+    // Virtual node for the destination, reached through goal_costs
+    constexpr int goal_node = node_count;
+
+    const int from_cluster = cluster_index( from.x / SEEX, from.y / SEEY );
+    const int to_cluster = cluster_index( to.x / SEEX, to.y / SEEY );
+
+    std::array<int, SEEX * SEEY> dist;
+    const auto local_dist = [&dist]( const point & p ) {
+        return dist[( p.x % SEEX ) * SEEY + p.y % SEEY];
+    };
+
+    std::vector<int> gscore( node_count + 1, -1 );
+    std::vector<int> parent( node_count + 1, -1 );
+    std::priority_queue< std::pair<int, int>, std::vector< std::pair<int, int> >, pair_greater_cmp_first >
+    open;
+    const auto add_node = [&]( const int node, const int g, const int par, const point & pos ) {
+        if( gscore[node] >= 0 && gscore[node] <= g ) {
+            return;
+        }
+        gscore[node] = g;
+        parent[node] = par;
+        open.emplace( g + 2 * square_dist( pos.x, pos.y, to.x, to.y ), node );
+    };
+
+    cluster_distances( cache, from_cluster % MAPSIZE, from_cluster / MAPSIZE, from, dist );
+    const pathfinding_cluster &start = cache.clusters[from_cluster];
+    for( size_t i = 0; i < start.entrances.size(); i++ ) {
+        const int d = local_dist( start.entrances[i].pos );
+        if( d >= 0 ) {
+            add_node( from_cluster * max_entrances + i, d, -1, start.entrances[i].pos );
+        }
+    }
+
+    cluster_distances( cache, to_cluster % MAPSIZE, to_cluster / MAPSIZE, to, dist );
+    const pathfinding_cluster &goal = cache.clusters[to_cluster];
+    std::vector<int> goal_costs( goal.entrances.size() );
+    for( size_t i = 0; i < goal.entrances.size(); i++ ) {
+        goal_costs[i] = local_dist( goal.entrances[i].pos );
+    }
+
+    std::vector<bool> closed( node_count + 1, false );
+    bool found = false;
+    while( !open.empty() ) {
+        const int node = open.top().second;
+        open.pop();
+        if( closed[node] ) {
+            continue;
+        }
+        closed[node] = true;
+        if( node == goal_node ) {
+            found = true;
+            break;
+        }
+
+        const int cl = node / max_entrances;
+        const size_t ent = node % max_entrances;
+        const pathfinding_cluster &cluster = cache.clusters[cl];
+        const size_t count = cluster.entrances.size();
+        const int g = gscore[node];
+
+        if( cl == to_cluster && goal_costs[ent] >= 0 ) {
+            add_node( goal_node, g + goal_costs[ent], node, to );
+        }
+
+        for( size_t j = 0; j < count; j++ ) {
+            const int cost = cluster.costs[ent * count + j];
+            if( j != ent && cost >= 0 ) {
+                add_node( cl * max_entrances + j, g + cost, node, cluster.entrances[j].pos );
+            }
+        }
+
+        const point &partner = cluster.entrances[ent].partner;
+        const int partner_cl = cluster_index( partner.x / SEEX, partner.y / SEEY );
+        const pathfinding_cluster &other = cache.clusters[partner_cl];
+        for( size_t j = 0; j < other.entrances.size(); j++ ) {
+            if( other.entrances[j].pos == partner ) {
+                add_node( partner_cl * max_entrances + j, g + cluster_tile_cost( cache.special[partner.x][partner.y] ),
+                          node, partner );
+                break;
+            }
+        }
+    }
+
+    if( !found ) {
+        return false;
+    }
+
+    corridor.reset();
+    corridor.set( from_cluster );
+    corridor.set( to_cluster );
+    for( int node = parent[goal_node]; node >= 0; node = parent[node] ) {
+        corridor.set( node / max_entrances );
+    }
+    return true;
+}
+
 template<class Set1, class Set2>
 bool is_disjoint( const Set1 &set1, const Set2 &set2 )
 {
@@ -180,6 +471,118 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+int map::pathfinding_step_cost( const tripoint &cur, const tripoint &p, const pf_special p_special,
+                                const pathfinding_settings &settings ) const
+{
+    // TODO: De-uglify, de-huge-n
+    if( !( p_special & non_normal ) ) {
+        // Boring flat dirt - the most common case above the ground
+        return 2;
+    }
+
+    const int bash = settings.bash_strength;
+    const int climb_cost = settings.climb_cost;
+    const bool doors = settings.allow_open_doors;
+
+    if( settings.avoid_rough_terrain ) {
+        // Close all rough terrain tiles
+        return pf_step_closed;
+    }
+
+    int part = -1;
+    const maptile &tile = maptile_at_internal( p );
+    const auto &terrain = tile.get_ter_t();
+    const auto &furniture = tile.get_furn_t();
+    const vehicle *veh = veh_at_internal( p, part );
+
+    const int cost = move_cost_internal( furniture, terrain, veh, part );
+    // Don't calculate bash rating unless we intend to actually use it
+    const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                       bash_rating_internal( bash, furniture, terrain, false, veh, part );
+
+    if( cost == 0 && rating <= 0 && ( !doors || !terrain.open ) && veh == nullptr && climb_cost <= 0 ) {
+        return pf_step_closed;
+    }
+
+    int newg = cost;
+    if( cost == 0 ) {
+        if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
+            // Climbing fences
+            newg += climb_cost;
+        } else if( doors && terrain.open &&
+                   ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !is_outside( cur ) ) ) {
+            // Only try to open INSIDE doors from the inside
+            // To open and then move onto the tile
+            newg += 4;
+        } else if( veh != nullptr ) {
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
+            part = vpobst ? vpobst->part_index() : -1;
+            int dummy = -1;
+            if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
+                ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
+                  veh_at_internal( cur, dummy ) == veh ) ) {
+                // Handle car doors, but don't try to path through curtains
+                newg += 10; // One turn to open, 4 to move there
+            } else if( part >= 0 && bash > 0 ) {
+                // Car obstacle that isn't a door
+                // TODO: Account for armor
+                int hp = veh->parts[part].hp();
+                if( hp / 20 > bash ) {
+                    // Threshold damage thing means we just can't bash this down
+                    return pf_step_closed;
+                } else if( hp / 10 > bash ) {
+                    // Threshold damage thing means we will fail to deal damage pretty often
+                    hp *= 2;
+                }
+
+                newg += 2 * hp / bash + 8 + 4;
+            } else if( part >= 0 ) {
+                if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
+                    // Won't be openable, don't try from other sides
+                    return pf_step_closed;
+                }
+
+                return pf_step_blocked;
+            }
+        } else if( rating > 1 ) {
+            // Expected number of turns to bash it down, 1 turn to move there
+            // and 5 turns of penalty not to trash everything just because we can
+            newg += ( 20 / rating ) + 2 + 10;
+        } else if( rating == 1 ) {
+            // Desperate measures, avoid whenever possible
+            newg += 500;
+        } else {
+            // Unbashable and unopenable from here
+            if( !doors || !terrain.open ) {
+                // Or anywhere else for that matter
+                return pf_step_closed;
+            }
+
+            return pf_step_blocked;
+        }
+    }
+
+    if( settings.avoid_traps && p_special & PF_TRAP ) {
+        const auto &ter_trp = terrain.trap.obj();
+        const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+        if( !trp.is_benign() ) {
+            // For now make them detect all traps
+            if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
+                // Special case - ledge in z-levels
+                // Warning: really expensive, needs a cache
+                if( valid_move( p, tripoint( p.x, p.y, p.z - 1 ), false, true ) ) {
+                    return pf_step_ledge;
+                }
+            } else {
+                // Otherwise it's walkable
+                newg += 500;
+            }
+        }
+    }
+
+    return newg;
+}
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -200,7 +603,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     }
     // First, check for a simple straight line on flat ground
     // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    static const auto non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP;
     if( f.z == t.z ) {
         const auto line_path = line_to( f, t );
         const auto &pf_cache = get_pathfinding_cache_ref( f.z );
@@ -221,12 +623,32 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return ret;
     }
 
+    // For long routes, find a corridor of clusters on the abstract graph first,
+    // so that the tile-level search doesn't need to explore the whole bounding box
+    if( f.z == t.z && rl_dist( f, t ) > hierarchical_route_min_dist ) {
+        std::bitset<MAPSIZE * MAPSIZE> corridor;
+        get_pathfinding_cache_ref( f.z );
+        if( find_cluster_corridor( get_pathfinding_cache( f.z ), my_MAPSIZE,
+                                   point( f.x, f.y ), point( t.x, t.y ), corridor ) ) {
+            ret = route_in_corridor( f, t, settings, pre_closed, &corridor );
+            if( !ret.empty() ) {
+                return ret;
+            }
+        }
+    }
+
+    // The abstract graph doesn't know about bashing, doors or climbing
+    return route_in_corridor( f, t, settings, pre_closed, nullptr );
+}
+
+std::vector<tripoint> map::route_in_corridor( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings,
+        const std::set<tripoint> &pre_closed,
+        const std::bitset<MAPSIZE * MAPSIZE> *corridor ) const
+{
+    std::vector<tripoint> ret;
+
     int max_length = settings.max_length;
-    int bash = settings.bash_strength;
-    int climb_cost = settings.climb_cost;
-    bool doors = settings.allow_open_doors;
-    bool trapavoid = settings.avoid_traps;
-    bool roughavoid = settings.avoid_rough_terrain;
 
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
     int minx = std::min( f.x, t.x ) - pad;
@@ -235,14 +657,32 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     int maxx = std::max( f.x, t.x ) + pad;
     int maxy = std::max( f.y, t.y ) + pad;
     int maxz = std::max( f.z, t.z ); // Same TODO: as above
+    if( corridor != nullptr ) {
+        // Bounding box of the corridor instead
+        minx = MAPSIZE_X;
+        miny = MAPSIZE_Y;
+        maxx = 0;
+        maxy = 0;
+        for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+            for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+                if( ( *corridor )[cluster_index( smx, smy )] ) {
+                    minx = std::min( minx, smx * SEEX );
+                    miny = std::min( miny, smy * SEEY );
+                    maxx = std::max( maxx, ( smx + 1 ) * SEEX );
+                    maxy = std::max( maxy, ( smy + 1 ) * SEEY );
+                }
+            }
+        }
+    }
     clip_to_bounds( minx, miny, minz );
     clip_to_bounds( maxx, maxy, maxz );
 
-    pathfinder pf( minx, miny, maxx, maxy );
+    pathfinder pf( minx, miny, maxx, maxy, corridor );
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
-        if( p.x >= minx && p.x < maxx && p.y >= miny && p.y < maxy ) {
+        if( p.x >= minx && p.x < maxx && p.y >= miny && p.y < maxy &&
+            ( corridor == nullptr || ( *corridor )[cluster_index( p.x / SEEX, p.y / SEEY )] ) ) {
             pf.close_point( p );
         }
     }
@@ -293,6 +733,10 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
+            if( corridor != nullptr && !( *corridor )[cluster_index( p.x / SEEX, p.y / SEEY )] ) {
+                continue;
+            }
+
             if( layer.state[index] == ASL_CLOSED ) {
                 continue;
             }
@@ -300,122 +744,29 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             // Penalize for diagonals or the path will look "unnatural"
             int newg = layer.gscore[parent_index] + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
 
-            const auto p_special = pf_cache.special[p.x][p.y];
-            // TODO: De-uglify, de-huge-n
-            if( !( p_special & non_normal ) ) {
-                // Boring flat dirt - the most common case above the ground
-                newg += 2;
-            } else {
-                if( roughavoid ) {
-                    layer.state[index] = ASL_CLOSED; // Close all rough terrain tiles
-                    continue;
-                }
-
-                int part = -1;
-                const maptile &tile = maptile_at_internal( p );
-                const auto &terrain = tile.get_ter_t();
-                const auto &furniture = tile.get_furn_t();
-                const vehicle *veh = veh_at_internal( p, part );
-
-                const int cost = move_cost_internal( furniture, terrain, veh, part );
-                // Don't calculate bash rating unless we intend to actually use it
-                const int rating = ( bash == 0 || cost != 0 ) ? -1 :
-                                   bash_rating_internal( bash, furniture, terrain, false, veh, part );
-
-                if( cost == 0 && rating <= 0 && ( !doors || !terrain.open ) && veh == nullptr && climb_cost <= 0 ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
-                    continue;
-                }
-
-                newg += cost;
-                if( cost == 0 ) {
-                    if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
-                        // Climbing fences
-                        newg += climb_cost;
-                    } else if( doors && terrain.open &&
-                               ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !is_outside( cur ) ) ) {
-                        // Only try to open INSIDE doors from the inside
-                        // To open and then move onto the tile
-                        newg += 4;
-                    } else if( veh != nullptr ) {
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
-                        part = vpobst ? vpobst->part_index() : -1;
-                        int dummy = -1;
-                        if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
-                            ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
-                              veh_at_internal( cur, dummy ) == veh ) ) {
-                            // Handle car doors, but don't try to path through curtains
-                            newg += 10; // One turn to open, 4 to move there
-                        } else if( part >= 0 && bash > 0 ) {
-                            // Car obstacle that isn't a door
-                            // TODO: Account for armor
-                            int hp = veh->parts[part].hp();
-                            if( hp / 20 > bash ) {
-                                // Threshold damage thing means we just can't bash this down
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            } else if( hp / 10 > bash ) {
-                                // Threshold damage thing means we will fail to deal damage pretty often
-                                hp *= 2;
-                            }
-
-                            newg += 2 * hp / bash + 8 + 4;
-                        } else if( part >= 0 ) {
-                            if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
-                                // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
-                            }
-
-                            continue;
-                        }
-                    } else if( rating > 1 ) {
-                        // Expected number of turns to bash it down, 1 turn to move there
-                        // and 5 turns of penalty not to trash everything just because we can
-                        newg += ( 20 / rating ) + 2 + 10;
-                    } else if( rating == 1 ) {
-                        // Desperate measures, avoid whenever possible
-                        newg += 500;
-                    } else {
-                        // Unbashable and unopenable from here
-                        if( !doors || !terrain.open ) {
-                            // Or anywhere else for that matter
-                            layer.state[index] = ASL_CLOSED;
-                        }
-
-                        continue;
-                    }
+            const int step_cost = pathfinding_step_cost( cur, p, pf_cache.special[p.x][p.y], settings );
+            if( step_cost == pf_step_closed ) {
+                // Close it so that next time we won't try to calculate costs
+                layer.state[index] = ASL_CLOSED;
+                continue;
+            } else if( step_cost == pf_step_blocked ) {
+                continue;
+            } else if( step_cost == pf_step_ledge ) {
+                tripoint below( p.x, p.y, p.z - 1 );
+                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
+                    // Otherwise this would have been a huge fall
+                    auto &layer = pf.get_layer( p.z - 1 );
+                    // From cur, not p, because we won't be walking on air
+                    pf.add_point( layer.gscore[parent_index] + 10,
+                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
+                                  cur, below );
                 }
 
-                if( trapavoid && p_special & PF_TRAP ) {
-                    const auto &ter_trp = terrain.trap.obj();
-                    const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
-                    if( !trp.is_benign() ) {
-                        // For now make them detect all traps
-                        if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
-                            // Special case - ledge in z-levels
-                            // Warning: really expensive, needs a cache
-                            if( valid_move( p, tripoint( p.x, p.y, p.z - 1 ), false, true ) ) {
-                                tripoint below( p.x, p.y, p.z - 1 );
-                                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
-                                    // Otherwise this would have been a huge fall
-                                    auto &layer = pf.get_layer( p.z - 1 );
-                                    // From cur, not p, because we won't be walking on air
-                                    pf.add_point( layer.gscore[parent_index] + 10,
-                                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
-                                                  cur, below );
-                                }
-
-                                // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            }
-                        } else if( trapavoid ) {
-                            // Otherwise it's walkable
-                            newg += 500;
-                        }
-                    }
-                }
+                // Close p, because we won't be walking on it
+                layer.state[index] = ASL_CLOSED;
+                continue;
             }
+            newg += step_cost;
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
@@ -490,3 +841,127 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+bool map::route_from_flow_field( const tripoint &f, const tripoint &t,
+                                 const pathfinding_settings &settings,
+                                 std::vector<tripoint> &path ) const
+{
+    if( f.z != t.z || f == t || !inbounds( f ) || !inbounds( t ) ) {
+        return false;
+    }
+
+    // Update first, so that the generation is current
+    get_pathfinding_cache_ref( t.z );
+    pathfinding_cache &cache = get_pathfinding_cache( t.z );
+
+    const int now = to_turn<int>( calendar::turn );
+    auto &fields = cache.flow_fields;
+    auto iter = std::find_if( fields.begin(), fields.end(),
+    [&t, &settings]( const pathfinding_flow_field & ff ) {
+        return ff.target == t && ff.settings == settings;
+    } );
+    if( iter == fields.end() ) {
+        if( fields.size() >= max_flow_fields ) {
+            fields.erase( std::min_element( fields.begin(), fields.end(),
+            []( const pathfinding_flow_field & lhs, const pathfinding_flow_field & rhs ) {
+                return lhs.request_turn < rhs.request_turn;
+            } ) );
+        }
+        fields.emplace_back();
+        iter = std::prev( fields.end() );
+        iter->target = t;
+        iter->settings = settings;
+    }
+
+    pathfinding_flow_field &field = *iter;
+    if( field.request_turn != now ) {
+        field.request_turn = now;
+        field.requests = 0;
+    }
+    field.requests++;
+
+    if( field.generation != cache.generation ) {
+        if( field.requests < flow_field_min_requests ) {
+            return false;
+        }
+        build_flow_field( field, cache );
+    }
+
+    path.clear();
+    int cur = flat_index( f.x, f.y );
+    if( field.dist[cur] < 0 ) {
+        return false;
+    }
+    const int target_index = flat_index( t.x, t.y );
+    // Just to limit max distance, in case something weird happens
+    for( int fdist = settings.max_length; fdist != 0 && cur != target_index; fdist-- ) {
+        cur = field.next[cur];
+        path.emplace_back( cur / MAPSIZE_Y, cur % MAPSIZE_Y, t.z );
+    }
+    if( cur != target_index ) {
+        path.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void map::build_flow_field( pathfinding_flow_field &field, const pathfinding_cache &cache ) const
+{
+    const tripoint &t = field.target;
+    const pathfinding_settings &settings = field.settings;
+    const int mapsize_x = SEEX * my_MAPSIZE;
+    const int mapsize_y = SEEY * my_MAPSIZE;
+
+    field.dist.assign( MAPSIZE_X * MAPSIZE_Y, -1 );
+    field.next.assign( MAPSIZE_X * MAPSIZE_Y, -1 );
+    field.generation = cache.generation;
+
+    std::vector<bool> closed( MAPSIZE_X * MAPSIZE_Y, false );
+    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
+    open;
+    field.dist[flat_index( t.x, t.y )] = 0;
+    open.emplace( 0, t );
+
+    // Dijkstra outwards from the target, walking every step backwards
+    constexpr std::array<int, 8> x_offset{{ -1,  1,  0,  0,  1, -1, -1, 1 }};
+    constexpr std::array<int, 8> y_offset{{  0,  0, -1,  1, -1,  1, -1, 1 }};
+    while( !open.empty() ) {
+        const tripoint cur = open.top().second;
+        open.pop();
+        const int cur_index = flat_index( cur.x, cur.y );
+        if( closed[cur_index] ) {
+            continue;
+        }
+        closed[cur_index] = true;
+        const int cur_dist = field.dist[cur_index];
+        if( cur_dist > settings.max_length ) {
+            // Everything else would be too long anyway
+            break;
+        }
+
+        const pf_special cur_special = cache.special[cur.x][cur.y];
+        for( size_t i = 0; i < 8; i++ ) {
+            const tripoint p( cur.x + x_offset[i], cur.y + y_offset[i], cur.z );
+            if( p.x < 0 || p.x >= mapsize_x || p.y < 0 || p.y >= mapsize_y ) {
+                continue;
+            }
+            const int index = flat_index( p.x, p.y );
+            if( closed[index] ) {
+                continue;
+            }
+
+            // Cost of stepping from p onto cur, the way map::route would see it
+            const int step_cost = pathfinding_step_cost( p, cur, cur_special, settings );
+            if( step_cost < 0 ) {
+                continue;
+            }
+            const int newdist = cur_dist + step_cost + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
+            if( field.dist[index] < 0 || newdist < field.dist[index] ) {
+                field.dist[index] = newdist;
+                field.next[index] = cur_index;
+                open.emplace( newdist, p );
+            }
+        }
+    }
+}
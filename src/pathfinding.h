@@ -2,7 +2,12 @@
 #ifndef PATHFINDING_H
 #define PATHFINDING_H
 
+#include <array>
+#include <bitset>
+#include <vector>
+
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : char {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -37,15 +42,6 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
-struct pathfinding_cache {
-    pathfinding_cache();
-    ~pathfinding_cache();
-
-    bool dirty;
-
-    pf_special special[MAPSIZE_X][MAPSIZE_Y];
-};
-
 struct pathfinding_settings {
     int bash_strength = 0;
     int max_dist = 0;
@@ -66,6 +62,73 @@ struct pathfinding_settings {
     pathfinding_settings( int bs, int md, int ml, int cc, bool aod, bool at, bool acs, bool art )
         : bash_strength( bs ), max_dist( md ), max_length( ml ), climb_cost( cc ),
           allow_open_doors( aod ), avoid_traps( at ), allow_climb_stairs( acs ), avoid_rough_terrain( art ) {}
+
+    bool operator==( const pathfinding_settings &rhs ) const {
+        return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+               max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+               allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+               allow_climb_stairs == rhs.allow_climb_stairs && avoid_rough_terrain == rhs.avoid_rough_terrain;
+    }
+};
+
+/**
+ * Remaining path cost to a single target from every tile of a z-level.
+ * Shared by all creatures that path to the same target with the same settings,
+ * so that a horde chasing the player costs one sweep instead of one A* per monster.
+ */
+struct pathfinding_flow_field {
+    tripoint target;
+    pathfinding_settings settings;
+
+    // Turn of the latest request for this field and number of requests during that turn
+    int request_turn = 0;
+    int requests = 0;
+
+    // pathfinding_cache::generation the field was built from, -1 if it wasn't built yet
+    int generation = -1;
+    // Cost of the path to the target, indexed by x * MAPSIZE_Y + y. -1 for unreachable tiles
+    std::vector<int> dist;
+    // Index of the next tile on the path to the target
+    std::vector<int> next;
+};
+
+/**
+ * A submap-sized cluster of the abstract pathfinding graph.
+ * Nodes of the graph are entrance tiles on cluster borders, connected to the
+ * matching entrance of the neighboring cluster and, through precomputed walking
+ * costs, to the other entrances of their own cluster.
+ */
+struct pathfinding_cluster {
+    struct entrance {
+        // Map-local position of the entrance tile, inside this cluster
+        point pos;
+        // Adjacent entrance tile in the neighboring cluster
+        point partner;
+    };
+
+    std::vector<entrance> entrances;
+    // Cost of walking from entrance i to entrance j without leaving the cluster,
+    // stored at [i * entrances.size() + j]. -1 means unreachable.
+    std::vector<int> costs;
+};
+
+struct pathfinding_cache {
+    pathfinding_cache();
+    ~pathfinding_cache();
+
+    bool dirty;
+    // Submaps (indexed by smx + smy * MAPSIZE) whose tiles in special need an update
+    std::bitset<MAPSIZE * MAPSIZE> dirty_submaps;
+    // Clusters whose entrances or internal costs are outdated
+    std::bitset<MAPSIZE * MAPSIZE> dirty_clusters;
+
+    pf_special special[MAPSIZE_X][MAPSIZE_Y];
+
+    std::array<pathfinding_cluster, MAPSIZE * MAPSIZE> clusters;
+
+    // Incremented every time special is recalculated, so that data built from it can tell it's outdated
+    int generation = 0;
+    std::vector<pathfinding_flow_field> flow_fields;
 };
 
 #endif
@@ -11864,6 +11864,12 @@ void player::on_mutation_loss( const trait_id &mid )
     magic.on_mutation_loss( mid );
 }
 
+void player::on_mutations_changed()
+{
+    // Traits like DEBUG_HS and BURROW change what can be crafted.
+    invalidate_crafting_inventory();
+}
+
 void player::on_stat_change( const std::string &stat, int value )
 {
     morale->on_stat_change( stat, value );
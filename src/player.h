@@ -54,6 +54,7 @@ static const std::string DEFAULT_HOTKEYS( "1234567890abcdefghijklmnopqrstuvwxyz"
 
 class craft_command;
 class recipe_subset;
+class requirement_lookup_cache;
 
 enum action_id : int;
 struct bionic;
@@ -1441,6 +1442,12 @@ class player : public Character
         const inventory &crafting_inventory( const tripoint &src_pos = tripoint_zero,
                                              int radius = PICKUP_RANGE );
         void invalidate_crafting_inventory();
+        /**
+         * Returns whether the requirements of @p r are met by the crafting inventory around
+         * the player. Results are kept, and lookups shared between recipes, until the crafting
+         * inventory or the traits change.
+         */
+        bool is_recipe_available( const recipe &r );
         comp_selection<item_comp>
         select_item_component( const std::vector<item_comp> &components,
                                int batch, inventory &map_inv, bool can_cancel = false,
@@ -1680,6 +1687,10 @@ class player : public Character
          * Called when a mutation is lost
          */
         void on_mutation_loss( const trait_id &mid ) override;
+        /**
+         * Called when a mutation was set or unset, before its effects are applied
+         */
+        void on_mutations_changed() override;
         /**
          * Called when a stat is changed
          */
@@ -1838,6 +1849,7 @@ class player : public Character
         int cached_moves;
         time_point cached_time;
         tripoint cached_position;
+        pimpl<requirement_lookup_cache> cached_requirement_lookups;
 
     private:
 
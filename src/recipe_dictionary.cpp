@@ -12,6 +12,7 @@
 #include "itype.h"
 #include "output.h"
 #include "skill.h"
+#include "translations.h"
 #include "uistate.h"
 #include "debug.h"
 #include "json.h"
@@ -73,27 +74,111 @@ const recipe &recipe_dictionary::get_uncraft( const itype_id &id )
     return iter != recipe_dict.uncraft.end() ? iter->second : null_recipe;
 }
 
-// searches for left-anchored partial match in the relevant recipe requirements set
+// Texts of the requirements a recipe is searched by
 template <class group>
-bool search_reqs( group gp, const std::string &txt )
+static void add_req_texts( const group &gp, std::vector<std::string> &texts )
 {
-    return std::any_of( gp.begin(), gp.end(), [&]( const typename group::value_type & opts ) {
-        return std::any_of( opts.begin(),
-        opts.end(), [&]( const typename group::value_type::value_type & e ) {
-            return lcmatch( e.to_string(), txt );
-        } );
-    } );
+    for( const auto &opts : gp ) {
+        for( const auto &e : opts ) {
+            texts.push_back( e.to_string() );
+        }
+    }
 }
 // template specialization to make component searches easier
 template<>
-bool search_reqs( std::vector<std::vector<item_comp> >  gp,
-                  const std::string &txt )
+void add_req_texts( const std::vector<std::vector<item_comp> > &gp,
+                    std::vector<std::string> &texts )
 {
-    return std::any_of( gp.begin(), gp.end(), [&]( const std::vector<item_comp> &opts ) {
-        return std::any_of( opts.begin(), opts.end(), [&]( const item_comp & ic ) {
-            return lcmatch( item::nname( ic.type ), txt );
-        } );
-    } );
+    for( const std::vector<item_comp> &opts : gp ) {
+        for( const item_comp &ic : opts ) {
+            texts.push_back( item::nname( ic.type ) );
+        }
+    }
+}
+
+static std::vector<std::string> search_texts( const recipe &r,
+        const recipe_subset::search_type key )
+{
+    std::vector<std::string> texts;
+    switch( key ) {
+        case recipe_subset::search_type::name:
+            texts.push_back( r.result_name() );
+            break;
+
+        case recipe_subset::search_type::skill:
+            texts.push_back( r.required_skills_string( nullptr ) );
+            texts.push_back( r.skill_used->name() );
+            break;
+
+        case recipe_subset::search_type::primary_skill:
+            texts.push_back( r.skill_used->name() );
+            break;
+
+        case recipe_subset::search_type::component:
+            add_req_texts( r.requirements().get_components(), texts );
+            break;
+
+        case recipe_subset::search_type::tool:
+            add_req_texts( r.requirements().get_tools(), texts );
+            break;
+
+        case recipe_subset::search_type::quality:
+            add_req_texts( r.requirements().get_qualities(), texts );
+            break;
+
+        case recipe_subset::search_type::quality_result: {
+            const auto &quals = item::find_type( r.result() )->qualities;
+            for( const std::pair<const quality_id, int> &e : quals ) {
+                texts.push_back( e.first->name );
+            }
+            break;
+        }
+
+        case recipe_subset::search_type::description_result: {
+            const item result = r.create_result();
+            texts.push_back( remove_color_tags( result.info( true ) ) );
+            break;
+        }
+    }
+    return texts;
+}
+
+/**
+ * The texts recipes are searched by, mapped to the recipes with that text.
+ * Most texts are shared by many recipes, e.g. the names of common components, so there
+ * are far fewer texts to compare than recipes. Each index is built on the first search
+ * of its type, and again after the language changed.
+ */
+static std::map<recipe_subset::search_type, std::map<std::string, std::vector<const recipe *>>>
+        search_indexes;
+static int search_indexes_language = 0;
+
+static const std::map<std::string, std::vector<const recipe *>> &search_index(
+            const recipe_subset::search_type key )
+{
+    if( search_indexes_language != get_language_version() ) {
+        search_indexes.clear();
+        search_indexes_language = get_language_version();
+    }
+    const auto iter = search_indexes.find( key );
+    if( iter != search_indexes.end() ) {
+        return iter->second;
+    }
+
+    std::map<std::string, std::vector<const recipe *>> &index = search_indexes[key];
+    for( const auto &e : recipe_dict ) {
+        const recipe &r = e.second;
+        if( !r || r.obsolete ) {
+            continue;
+        }
+        for( const std::string &text : search_texts( r, key ) ) {
+            std::vector<const recipe *> &with_text = index[text];
+            if( with_text.empty() || with_text.back() != &r ) {
+                with_text.push_back( &r );
+            }
+        }
+    }
+    return index;
 }
 
 std::vector<const recipe *> recipe_subset::favorite() const
@@ -147,46 +232,24 @@ std::vector<const recipe *> recipe_subset::search( const std::string &txt,
 {
     std::vector<const recipe *> res;
 
-    std::copy_if( recipes.begin(), recipes.end(), std::back_inserter( res ), [&]( const recipe * r ) {
-        if( !*r || r->obsolete ) {
-            return false;
-        }
-        switch( key ) {
-            case search_type::name:
-                return lcmatch( r->result_name(), txt );
-
-            case search_type::skill:
-                return lcmatch( r->required_skills_string( nullptr ), txt ) ||
-                       lcmatch( r->skill_used->name(), txt );
-
-            case search_type::primary_skill:
-                return lcmatch( r->skill_used->name(), txt );
-
-            case search_type::component:
-                return search_reqs( r->requirements().get_components(), txt );
-
-            case search_type::tool:
-                return search_reqs( r->requirements().get_tools(), txt );
-
-            case search_type::quality:
-                return search_reqs( r->requirements().get_qualities(), txt );
-
-            case search_type::quality_result: {
-                const auto &quals = item::find_type( r->result() )->qualities;
-                return std::any_of( quals.begin(), quals.end(), [&]( const std::pair<quality_id, int> &e ) {
-                    return lcmatch( e.first->name, txt );
-                } );
-            }
-
-            case search_type::description_result: {
-                const item result = r->create_result();
-                return lcmatch( remove_color_tags( result.info( true ) ), txt );
-            }
+    if( key == search_type::description_result ) {
+        // The description depends on the player, so it can't be indexed.
+        std::copy_if( recipes.begin(), recipes.end(), std::back_inserter( res ),
+        [&]( const recipe * r ) {
+            return *r && !r->obsolete && lcmatch( search_texts( *r, key ).front(), txt );
+        } );
+        return res;
+    }
 
-            default:
-                return false;
+    std::vector<const recipe *> matching;
+    for( const auto &e : search_index( key ) ) {
+        if( lcmatch( e.first, txt ) ) {
+            matching.insert( matching.end(), e.second.begin(), e.second.end() );
         }
-    } );
+    }
+    std::sort( matching.begin(), matching.end(), std::less<const recipe *>() );
+    std::set_intersection( recipes.begin(), recipes.end(), matching.begin(), matching.end(),
+                           std::back_inserter( res ), std::less<const recipe *>() );
 
     return res;
 }
@@ -415,10 +478,13 @@ void recipe_dictionary::finalize()
             recipe_dict.blueprints.insert( &e.second );
         }
     }
+
+    search_indexes.clear();
 }
 
 void recipe_dictionary::reset()
 {
+    search_indexes.clear();
     recipe_dict.blueprints.clear();
     recipe_dict.autolearn.clear();
     recipe_dict.recipes.clear();
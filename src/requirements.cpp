@@ -564,6 +564,14 @@ std::vector<std::string> requirement_data::get_folded_tools_list( int width, nc_
 
 bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
         const std::function<bool( const item & )> &filter, int batch ) const
+{
+    requirement_lookup_cache lookups;
+    return can_make_with_inventory( crafting_inv, filter, batch, lookups );
+}
+
+bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
+        const std::function<bool( const item & )> &filter, int batch,
+        requirement_lookup_cache &lookups ) const
 {
     if( g->u.has_trait( trait_DEBUG_HS ) ) {
         return true;
@@ -571,13 +579,13 @@ bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
 
     bool retval = true;
     // All functions must be called to update the available settings in the components.
-    if( !has_comps( crafting_inv, qualities, return_true<item> ) ) {
+    if( !has_comps( crafting_inv, qualities, return_true<item>, 1, &lookups ) ) {
         retval = false;
     }
-    if( !has_comps( crafting_inv, tools, return_true<item>, batch ) ) {
+    if( !has_comps( crafting_inv, tools, return_true<item>, batch, &lookups ) ) {
         retval = false;
     }
-    if( !has_comps( crafting_inv, components, filter, batch ) ) {
+    if( !has_comps( crafting_inv, components, filter, batch, &lookups ) ) {
         retval = false;
     }
     if( !check_enough_materials( crafting_inv, filter, batch ) ) {
@@ -586,21 +594,64 @@ bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
     return retval;
 }
 
+template<typename T>
+static void get_availability( const std::vector< std::vector<T> > &vec,
+                              std::vector<available_status> &availability )
+{
+    for( const std::vector<T> &set_of_comps : vec ) {
+        for( const T &comp : set_of_comps ) {
+            availability.push_back( comp.available );
+        }
+    }
+}
+
+template<typename T>
+static void set_availability( const std::vector< std::vector<T> > &vec,
+                              std::vector<available_status>::const_iterator &iter )
+{
+    for( const std::vector<T> &set_of_comps : vec ) {
+        for( const T &comp : set_of_comps ) {
+            comp.available = *iter++;
+        }
+    }
+}
+
+std::vector<available_status> requirement_data::get_availability() const
+{
+    std::vector<available_status> availability;
+    ::get_availability( qualities, availability );
+    ::get_availability( tools, availability );
+    ::get_availability( components, availability );
+    return availability;
+}
+
+void requirement_data::set_availability( const std::vector<available_status> &availability ) const
+{
+    auto iter = availability.begin();
+    ::set_availability( qualities, iter );
+    ::set_availability( tools, iter );
+    ::set_availability( components, iter );
+}
+
 template<typename T>
 bool requirement_data::has_comps( const inventory &crafting_inv,
                                   const std::vector< std::vector<T> > &vec,
                                   const std::function<bool( const item & )> &filter,
-                                  int batch )
+                                  int batch, requirement_lookup_cache *lookups )
 {
     bool retval = true;
     int total_UPS_charges_used = 0;
     for( const auto &set_of_tools : vec ) {
         bool has_tool_in_set = false;
         int UPS_charges_used = std::numeric_limits<int>::max();
-        for( const auto &tool : set_of_tools ) {
-            if( tool.has( crafting_inv, filter, batch, [ &UPS_charges_used ]( int charges ) {
+        const std::function<void( int )> visitor = [ &UPS_charges_used ]( int charges ) {
             UPS_charges_used = std::min( UPS_charges_used, charges );
-            } ) ) {
+        };
+        for( const auto &tool : set_of_tools ) {
+            const bool has_tool = lookups ?
+                                  lookups->has( tool, crafting_inv, filter, batch, visitor ) :
+                                  tool.has( crafting_inv, filter, batch, visitor );
+            if( has_tool ) {
                 tool.available = a_true;
             } else {
                 tool.available = a_false;
@@ -621,6 +672,71 @@ bool requirement_data::has_comps( const inventory &crafting_inv,
     return retval;
 }
 
+bool requirement_lookup_cache::has( const quality_requirement &req, const inventory &crafting_inv,
+                                    const std::function<bool( const item & )> &filter, int batch,
+                                    const std::function<void( int )> &visitor )
+{
+    const auto key = std::make_pair( req.type, std::make_pair( req.level, req.count ) );
+    const auto iter = qualities.find( key );
+    if( iter != qualities.end() ) {
+        return iter->second;
+    }
+    const bool found = req.has( crafting_inv, filter, batch, visitor );
+    qualities.emplace( key, found );
+    return found;
+}
+
+bool requirement_lookup_cache::has( const tool_comp &req, const inventory &crafting_inv,
+                                    const std::function<bool( const item & )> &filter, int batch,
+                                    const std::function<void( int )> &visitor )
+{
+    const auto key = std::make_pair( req.type, std::make_pair( req.count, batch ) );
+    const auto iter = tools.find( key );
+    if( iter != tools.end() ) {
+        if( iter->second.UPS_charges >= 0 && visitor ) {
+            visitor( iter->second.UPS_charges );
+        }
+        return iter->second.found;
+    }
+    tool_lookup lookup{ false, -1 };
+    lookup.found = req.has( crafting_inv, filter, batch, [&lookup, &visitor]( int charges ) {
+        lookup.UPS_charges = charges;
+        if( visitor ) {
+            visitor( charges );
+        }
+    } );
+    tools.emplace( key, lookup );
+    return lookup.found;
+}
+
+bool requirement_lookup_cache::has( const item_comp &req, const inventory &crafting_inv,
+                                    const std::function<bool( const item & )> &filter, int batch,
+                                    const std::function<void( int )> &visitor )
+{
+    return req.has( crafting_inv, filter, batch, visitor );
+}
+
+bool requirement_lookup_cache::can_make( const requirement_data &req,
+        const inventory &crafting_inv, const std::function<bool( const item & )> &filter )
+{
+    const auto iter = requirements.find( &req );
+    if( iter != requirements.end() ) {
+        // Other batch sizes may have been checked since, the crafting menu shows these flags.
+        req.set_availability( iter->second.availability );
+        return iter->second.found;
+    }
+    const bool found = req.can_make_with_inventory( crafting_inv, filter, 1, *this );
+    requirements.emplace( &req, requirement_lookup{ found, req.get_availability() } );
+    return found;
+}
+
+void requirement_lookup_cache::clear()
+{
+    requirements.clear();
+    qualities.clear();
+    tools.clear();
+}
+
 bool quality_requirement::has( const inventory &crafting_inv,
                                const std::function<bool( const item & )> &, int, std::function<void( int )> ) const
 {
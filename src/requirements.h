@@ -124,6 +124,55 @@ struct quality_requirement {
     }
 };
 
+struct requirement_data;
+
+/**
+ * Remembers which tools and qualities were found in a crafting inventory.
+ * Many requirements need the same tools and qualities, so when evaluating many of them
+ * with the same inventory each one only has to be looked up once.
+ * Must be cleared whenever the inventory changes.
+ */
+class requirement_lookup_cache
+{
+    public:
+        bool has( const quality_requirement &req, const inventory &crafting_inv,
+                  const std::function<bool( const item & )> &filter, int batch,
+                  const std::function<void( int )> &visitor );
+        bool has( const tool_comp &req, const inventory &crafting_inv,
+                  const std::function<bool( const item & )> &filter, int batch,
+                  const std::function<void( int )> &visitor );
+        /** Components are filtered by the recipe, so they are not remembered. */
+        bool has( const item_comp &req, const inventory &crafting_inv,
+                  const std::function<bool( const item & )> &filter, int batch,
+                  const std::function<void( int )> &visitor );
+
+        /**
+         * Whether @p req can be made once with the inventory, see
+         * @ref requirement_data::can_make_with_inventory. The answer is remembered together with
+         * the available flags it left in the components, and those are restored when @p req
+         * is asked again. Each requirement must always be asked with the same @p filter.
+         */
+        bool can_make( const requirement_data &req, const inventory &crafting_inv,
+                       const std::function<bool( const item & )> &filter );
+
+        void clear();
+
+    private:
+        struct requirement_lookup {
+            bool found;
+            // The available flags of the qualities, tools and components, in that order.
+            std::vector<available_status> availability;
+        };
+        std::map<const requirement_data *, requirement_lookup> requirements;
+        std::map<std::pair<quality_id, std::pair<int, int>>, bool> qualities;
+        struct tool_lookup {
+            bool found;
+            // Charges of the UPS the tool would use, -1 if it would not use any.
+            int UPS_charges;
+        };
+        std::map<std::pair<itype_id, std::pair<int, int>>, tool_lookup> tools;
+};
+
 /**
  * The *_vector members represent list of alternatives requirements:
  * alter_tool_comp_vector = { * { { a, b }, { c, d } }
@@ -254,6 +303,22 @@ struct requirement_data {
          */
         bool can_make_with_inventory( const inventory &crafting_inv,
                                       const std::function<bool( const item & )> &filter, int batch = 1 ) const;
+        /**
+         * Same as above, but shares the tool and quality lookups with other requirements
+         * evaluated with the same inventory and cache.
+         * The tools and qualities are always looked up without a filter.
+         */
+        bool can_make_with_inventory( const inventory &crafting_inv,
+                                      const std::function<bool( const item & )> &filter, int batch,
+                                      requirement_lookup_cache &lookups ) const;
+
+        /**
+         * The available flags of all qualities, tools and components, as the last
+         * @ref can_make_with_inventory left them.
+         */
+        std::vector<available_status> get_availability() const;
+        /** Restores flags returned by @ref get_availability. */
+        void set_availability( const std::vector<available_status> &availability ) const;
 
         /** @param filter see @ref can_make_with_inventory */
         std::vector<std::string> get_folded_components_list( int width, nc_color col,
@@ -305,7 +370,8 @@ struct requirement_data {
                                                const std::vector< std::vector<T> > &objs );
         template<typename T>
         static bool has_comps( const inventory &crafting_inv, const std::vector< std::vector<T> > &vec,
-                               const std::function<bool( const item & )> &filter, int batch = 1 );
+                               const std::function<bool( const item & )> &filter, int batch = 1,
+                               requirement_lookup_cache *lookups = nullptr );
 
         template<typename T>
         std::vector<std::string> get_folded_list( int width, const inventory &crafting_inv,
@@ -0,0 +1,329 @@
+#include "save_writer.h"
+
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "cata_utility.h"
+#include "filesystem.h"
+#include "string_formatter.h"
+
+// MinGW without posix threads lacks std::thread, all saves are synchronous there.
+#if !defined(_WIN32) || defined(_MSC_VER)
+#   define CATA_BACKGROUND_SAVE
+#   include <condition_variable>
+#   include <mutex>
+#   include <thread>
+#endif
+
+struct save_writer_impl {
+    struct job {
+        std::string path;
+        std::string contents;
+        bool remove;
+        // Changes the file in place instead of writing contents.
+        std::function<void( const std::string & )> update;
+    };
+
+    bool collecting = false;
+    std::vector<job> collected;
+    std::chrono::steady_clock::time_point snapshot_start;
+
+#if defined(CATA_BACKGROUND_SAVE)
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<job> pending;
+    // Whether the worker is processing a job it took from pending.
+    bool writing = false;
+    bool stopping = false;
+
+    save_writer::save_stats stats;
+    save_writer::save_progress progress;
+    bool finished = false;
+    std::chrono::steady_clock::time_point write_start;
+
+    struct written_file {
+        size_t hash;
+        size_t size;
+    };
+    // What was last written to each file.
+    std::map<std::string, written_file> written;
+
+    static void write_atomically( const std::string &path, const std::string &contents ) {
+        const std::string temp_path = path + ".temp";
+        std::ofstream fout( temp_path.c_str(), std::ios::binary );
+        if( !fout.is_open() ) {
+            throw std::runtime_error( "opening file failed" );
+        }
+        fout.write( contents.data(), contents.size() );
+        fout.close();
+        if( fout.fail() ) {
+            remove_file( temp_path );
+            throw std::runtime_error( "writing to file failed" );
+        }
+        if( !rename_file( temp_path, path ) ) {
+            remove_file( temp_path );
+            throw std::runtime_error( "replacing the old file failed" );
+        }
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ) {
+            wake.wait( lock, [this]() {
+                return stopping || !pending.empty();
+            } );
+            if( pending.empty() ) {
+                // Only stops once everything has been written.
+                return;
+            }
+            const job current = std::move( pending.front() );
+            pending.pop_front();
+            writing = true;
+            const auto last = written.find( current.path );
+            const bool had_contents = last != written.end();
+            const written_file last_written = had_contents ? last->second : written_file{ 0, 0 };
+            lock.unlock();
+
+            const written_file contents_written{ std::hash<std::string>()( current.contents ),
+                                                 current.contents.size() };
+            bool unchanged = false;
+            std::string error;
+            try {
+                if( current.remove ) {
+                    if( file_exist( current.path ) && !remove_file( current.path ) ) {
+                        throw std::runtime_error( "removing the file failed" );
+                    }
+                } else if( current.update ) {
+                    current.update( current.path );
+                } else if( had_contents && last_written.hash == contents_written.hash &&
+                           last_written.size == contents_written.size && file_exist( current.path ) ) {
+                    unchanged = true;
+                } else {
+                    write_atomically( current.path, current.contents );
+                }
+            } catch( const std::exception &err ) {
+                error = string_format( "%s: %s", current.path, err.what() );
+            }
+
+            lock.lock();
+            writing = false;
+            progress.done++;
+            if( !error.empty() ) {
+                written.erase( current.path );
+                stats.errors.push_back( error );
+            } else if( current.remove ) {
+                written.erase( current.path );
+                stats.files_removed++;
+            } else if( current.update ) {
+                // Its contents are not known here.
+                written.erase( current.path );
+                stats.files_written++;
+            } else if( unchanged ) {
+                stats.files_unchanged++;
+            } else {
+                written[current.path] = contents_written;
+                stats.files_written++;
+                stats.bytes_written += current.contents.size();
+            }
+            if( pending.empty() ) {
+                stats.write_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::steady_clock::now() - write_start );
+                finished = true;
+                idle.notify_all();
+            }
+        }
+    }
+#endif
+};
+
+save_writer::save_writer() : impl( new save_writer_impl() )
+{
+}
+
+save_writer::~save_writer()
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    if( impl->worker.joinable() ) {
+        {
+            std::lock_guard<std::mutex> lock( impl->mutex );
+            impl->stopping = true;
+        }
+        impl->wake.notify_all();
+        impl->worker.join();
+    }
+#endif
+}
+
+bool save_writer::available()
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void save_writer::begin_save()
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    wait();
+    impl->collecting = true;
+    impl->collected.clear();
+    impl->snapshot_start = std::chrono::steady_clock::now();
+#endif
+}
+
+void save_writer::end_save()
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    if( !impl->collecting ) {
+        return;
+    }
+    impl->collecting = false;
+    const auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock( impl->mutex );
+        impl->stats = save_stats();
+        impl->stats.snapshot_time = std::chrono::duration_cast<std::chrono::milliseconds>
+                                    ( now - impl->snapshot_start );
+        impl->progress.done = 0;
+        impl->progress.total = impl->collected.size();
+        impl->write_start = now;
+        impl->finished = impl->collected.empty();
+        for( save_writer_impl::job &elem : impl->collected ) {
+            impl->pending.push_back( std::move( elem ) );
+        }
+    }
+    impl->collected.clear();
+    if( !impl->worker.joinable() ) {
+        impl->worker = std::thread( &save_writer_impl::work, impl.get() );
+    }
+    impl->wake.notify_one();
+#endif
+}
+
+bool save_writer::is_collecting() const
+{
+    return impl->collecting;
+}
+
+void save_writer::write( const std::string &path, std::string contents )
+{
+    impl->collected.push_back( { path, std::move( contents ), false, nullptr } );
+}
+
+void save_writer::update( const std::string &path,
+                          std::function<void( const std::string & )> update )
+{
+    impl->collected.push_back( { path, std::string(), false, std::move( update ) } );
+}
+
+void save_writer::remove( const std::string &path )
+{
+    impl->collected.push_back( { path, std::string(), true, nullptr } );
+}
+
+void save_writer::forget( const std::string &path )
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    impl->written.erase( path );
+#else
+    ( void ) path;
+#endif
+}
+
+bool save_writer::busy() const
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    return impl->writing || !impl->pending.empty();
+#else
+    return false;
+#endif
+}
+
+void save_writer::wait()
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    std::unique_lock<std::mutex> lock( impl->mutex );
+    impl->idle.wait( lock, [this]() {
+        return !impl->writing && impl->pending.empty();
+    } );
+#endif
+}
+
+save_writer::save_progress save_writer::progress() const
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    return impl->progress;
+#else
+    return save_progress();
+#endif
+}
+
+bool save_writer::take_finished( save_stats &stats )
+{
+#if defined(CATA_BACKGROUND_SAVE)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    if( !impl->finished ) {
+        return false;
+    }
+    impl->finished = false;
+    stats = impl->stats;
+    return true;
+#else
+    ( void ) stats;
+    return false;
+#endif
+}
+
+save_writer &get_save_writer()
+{
+    static save_writer writer;
+    return writer;
+}
+
+void write_save_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
+                      const bool exclusive )
+{
+    save_writer &background = get_save_writer();
+    if( background.is_collecting() ) {
+        std::ostringstream contents;
+        writer( contents );
+        background.write( path, contents.str() );
+        return;
+    }
+    // A queued write would overwrite this file with older contents.
+    background.wait();
+    background.forget( path );
+    if( exclusive ) {
+        ofstream_wrapper_exclusive fout( path );
+        writer( fout.stream() );
+        fout.close();
+    } else {
+        ofstream_wrapper fout( path );
+        writer( fout.stream() );
+        fout.close();
+    }
+}
+
+void remove_save_file( const std::string &path )
+{
+    save_writer &background = get_save_writer();
+    if( background.is_collecting() ) {
+        background.remove( path );
+        return;
+    }
+    background.wait();
+    background.forget( path );
+    remove_file( path );
+}
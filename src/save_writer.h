@@ -0,0 +1,116 @@
+#pragma once
+#ifndef SAVE_WRITER_H
+#define SAVE_WRITER_H
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct save_writer_impl;
+
+/**
+ * Writes save files on a background thread, so saving doesn't stop the game for the time the
+ * file I/O takes.
+ *
+ * Between @ref begin_save and @ref end_save, files passed to @ref write_save_file are serialized
+ * into memory and collected instead of written. This in-memory copy is the snapshot of the
+ * game state; serializing has to happen on the main thread as it reads the live game objects.
+ * @ref end_save hands the collected files to the background thread, which writes each one to a
+ * temporary file next to its destination and renames it over the old file, so a save that is
+ * interrupted never leaves a partially written file behind. Files whose contents are the same
+ * as those this writer wrote last time are skipped.
+ */
+class save_writer
+{
+    public:
+        struct save_stats {
+            int files_written = 0;
+            /** Files skipped because their contents didn't change since the last save. */
+            int files_unchanged = 0;
+            int files_removed = 0;
+            size_t bytes_written = 0;
+            /** Time the main thread spent collecting the files. */
+            std::chrono::milliseconds snapshot_time{ 0 };
+            /** Time the background thread spent writing them. */
+            std::chrono::milliseconds write_time{ 0 };
+            /** One message per file that could not be written. */
+            std::vector<std::string> errors;
+        };
+
+        struct save_progress {
+            int done = 0;
+            int total = 0;
+        };
+
+        save_writer();
+        /** Finishes writing all queued files. */
+        ~save_writer();
+
+        save_writer( const save_writer & ) = delete;
+        save_writer &operator=( const save_writer & ) = delete;
+
+        /** Whether saving in the background is possible. False on platforms without threads. */
+        static bool available();
+
+        /**
+         * Starts collecting files for a background save. Waits for the previous background
+         * save to finish first. Does nothing if saving in the background is not available.
+         */
+        void begin_save();
+        /** Stops collecting files and starts writing them in the background. */
+        void end_save();
+        /** Whether files are currently collected, see @ref begin_save. */
+        bool is_collecting() const;
+
+        /** Queues writing @p contents to @p path. Only valid while collecting. */
+        void write( const std::string &path, std::string contents );
+        /**
+         * Queues changing the file @p path in place, for files that are not replaced as a whole.
+         * @p update is called with @p path on the background thread after the files queued
+         * before it are written, so it must not touch game state. Only valid while collecting.
+         */
+        void update( const std::string &path,
+                     std::function<void( const std::string & )> update );
+        /** Queues removing the file @p path after the files queued before it are written. */
+        void remove( const std::string &path );
+        /**
+         * Forgets what was written to @p path, so the next background save writes it even if
+         * its contents are the same. Needed whenever the file is changed by anything else.
+         */
+        void forget( const std::string &path );
+
+        /** Whether a background save is still being written. */
+        bool busy() const;
+        /**
+         * Blocks until all queued files have been written. Must be called before reading
+         * files that may still be queued.
+         */
+        void wait();
+        /** Progress of the background save that is being written, or the last one. */
+        save_progress progress() const;
+        /**
+         * Returns true and the statistics of the last background save in @p stats if it has
+         * finished since the last call.
+         */
+        bool take_finished( save_stats &stats );
+
+    private:
+        std::unique_ptr<save_writer_impl> impl;
+};
+
+save_writer &get_save_writer();
+
+/**
+ * Writes the save file @p path by calling @p writer on a stream. During a background save the
+ * output is queued with @ref get_save_writer, otherwise it is written right away, using exclusive
+ * I/O (@ref fopen_exclusive) if @p exclusive is set. Throws std::exception on failure.
+ */
+void write_save_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
+                      bool exclusive );
+/** Removes the save file @p path, after any queued writes during a background save. */
+void remove_save_file( const std::string &path );
+
+#endif
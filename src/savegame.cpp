@@ -260,6 +260,7 @@ void scent_map::deserialize( const std::string &data )
             val = stmp;
         }
     }
+    scent_bounds = nonzero_bounds( rectangle( point_zero, point( MAPSIZE_X - 1, MAPSIZE_Y - 1 ) ) );
 }
 
 ///// weather
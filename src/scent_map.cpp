@@ -11,7 +11,29 @@
 #include "output.h"
 #include "cursesdef.h"
 
-static constexpr int SCENT_RADIUS = 40;
+static const rectangle whole_map( point_zero, point( MAPSIZE_X - 1, MAPSIZE_Y - 1 ) );
+
+static bool is_empty( const rectangle &r )
+{
+    return r.p_min.x > r.p_max.x || r.p_min.y > r.p_max.y;
+}
+
+static rectangle intersection( const rectangle &a, const rectangle &b )
+{
+    return rectangle( point( std::max( a.p_min.x, b.p_min.x ), std::max( a.p_min.y, b.p_min.y ) ),
+                      point( std::min( a.p_max.x, b.p_max.x ), std::min( a.p_max.y, b.p_max.y ) ) );
+}
+
+static rectangle bounding_union( const rectangle &a, const rectangle &b )
+{
+    if( is_empty( a ) ) {
+        return b;
+    } else if( is_empty( b ) ) {
+        return a;
+    }
+    return rectangle( point( std::min( a.p_min.x, b.p_min.x ), std::min( a.p_min.y, b.p_min.y ) ),
+                      point( std::max( a.p_max.x, b.p_max.x ), std::max( a.p_max.y, b.p_max.y ) ) );
+}
 
 static nc_color sev( const size_t level )
 {
@@ -43,6 +65,10 @@ static nc_color sev( const size_t level )
     return level < colors.size() ? colors[level] : c_dark_gray;
 }
 
+scent_map::scent_map( const game &g ) : scent_bounds( whole_map ), gm( g )
+{
+}
+
 void scent_map::reset()
 {
     for( auto &elem : grscent ) {
@@ -50,15 +76,54 @@ void scent_map::reset()
             val = 0;
         }
     }
+    scent_bounds = rectangle( point_max, point_min );
 }
 
 void scent_map::decay()
 {
-    for( auto &elem : grscent ) {
-        for( auto &val : elem ) {
-            val = std::max( 0, val - 1 );
+    if( is_empty( scent_bounds ) ) {
+        return;
+    }
+    for( int x = scent_bounds.p_min.x; x <= scent_bounds.p_max.x; ++x ) {
+        for( int y = scent_bounds.p_min.y; y <= scent_bounds.p_max.y; ++y ) {
+            grscent[x][y] = std::max( 0, grscent[x][y] - 1 );
+        }
+    }
+    scent_bounds = nonzero_bounds( scent_bounds );
+}
+
+rectangle scent_map::nonzero_bounds( const rectangle &area ) const
+{
+    if( is_empty( area ) ) {
+        return area;
+    }
+    rectangle result( area.p_max + point( 1, 1 ), area.p_min - point( 1, 1 ) );
+    for( int x = area.p_min.x; x <= area.p_max.x; ++x ) {
+        const auto &column = grscent[x];
+        int any_scent = 0;
+        for( int y = area.p_min.y; y <= area.p_max.y; ++y ) {
+            any_scent |= column[y];
+        }
+        if( any_scent == 0 ) {
+            continue;
+        }
+        result.p_min.x = std::min( result.p_min.x, x );
+        result.p_max.x = x;
+        // Only the rows outside of the current result can extend it.
+        for( int y = area.p_min.y; y < result.p_min.y; ++y ) {
+            if( column[y] != 0 ) {
+                result.p_min.y = y;
+                break;
+            }
+        }
+        for( int y = area.p_max.y; y > result.p_max.y; --y ) {
+            if( column[y] != 0 ) {
+                result.p_max.y = y;
+                break;
+            }
         }
     }
+    return result;
 }
 
 void scent_map::draw( const catacurses::window &win, const int div, const tripoint &center ) const
@@ -84,6 +149,11 @@ void scent_map::shift( const int sm_shift_x, const int sm_shift_y )
         }
     }
     grscent = new_scent;
+    if( !is_empty( scent_bounds ) ) {
+        const point shift( sm_shift_x, sm_shift_y );
+        const rectangle shifted( scent_bounds.p_min - shift, scent_bounds.p_max - shift );
+        scent_bounds = intersection( shifted, whole_map );
+    }
 }
 
 int scent_map::get( const tripoint &p ) const
@@ -98,6 +168,10 @@ void scent_map::set( const tripoint &p, int value )
 {
     if( inbounds( p ) ) {
         grscent[p.x][p.y] = value;
+        if( value != 0 ) {
+            const point here( p.x, p.y );
+            scent_bounds = bounding_union( scent_bounds, rectangle( here, here ) );
+        }
     }
 }
 
@@ -135,91 +209,110 @@ void scent_map::update( const tripoint &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
-    // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
-    // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
-
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    scent_array<int> sum_3_scent_y;
-    scent_array<int> squares_used_y;
+    const rectangle area = diffusion_area( center );
+    if( is_empty( area ) ) {
+        return;
+    }
 
     // these are for caching flag lookups
     scent_array<bool> blocks_scent; // currently only TFLAG_WALL blocks scent
     scent_array<bool> reduces_scent;
 
-    // for loop constants
-    const int scentmap_minx = center.x - SCENT_RADIUS;
-    const int scentmap_maxx = center.x + SCENT_RADIUS;
-    const int scentmap_miny = center.y - SCENT_RADIUS;
-    const int scentmap_maxy = center.y + SCENT_RADIUS;
+    // The new scent flag searching function. Should be wayyy faster than the old one.
+    m.scent_blockers( blocks_scent, reduces_scent, area.p_min.x - 1, area.p_min.y - 1,
+                      area.p_max.x + 1, area.p_max.y + 1 );
+    diffuse( area, blocks_scent, reduces_scent );
+}
+
+rectangle scent_map::diffusion_area( const tripoint &center ) const
+{
+    if( is_empty( scent_bounds ) ) {
+        return scent_bounds;
+    }
+    const rectangle radius_area( point( center.x - SCENT_RADIUS, center.y - SCENT_RADIUS ),
+                                 point( center.x + SCENT_RADIUS, center.y + SCENT_RADIUS ) );
+    // Diffusing reads the cells around the area.
+    const rectangle map_interior( point( 1, 1 ), point( MAPSIZE_X - 2, MAPSIZE_Y - 2 ) );
+    // Scent spreads by one cell per turn, cells further away from all scent stay at zero.
+    const rectangle scent_reach( scent_bounds.p_min - point( 1, 1 ),
+                                 scent_bounds.p_max + point( 1, 1 ) );
+    return intersection( intersection( radius_area, map_interior ), scent_reach );
+}
+
+void scent_map::diffuse( const rectangle &area, const scent_array<bool> &blocks_scent,
+                         const scent_array<bool> &reduces_scent )
+{
+    // The intermediate arrays hold the area and one cell around it, index 0 is one cell
+    // before the start of the area.
+    static constexpr int max_size = 2 * SCENT_RADIUS + 3;
+    using local_array = std::array<std::array<int, max_size>, max_size>;
+    const int width = area.p_max.x - area.p_min.x + 1;
+    const int height = area.p_max.y - area.p_min.y + 1;
+    assert( width <= max_size - 2 && height <= max_size - 2 );
+    assert( area.p_min.x >= 1 && area.p_min.y >= 1 );
+    assert( area.p_max.x < MAPSIZE_X - 1 && area.p_max.y < MAPSIZE_Y - 1 );
+    const int offset_x = area.p_min.x - 1;
+    const int offset_y = area.p_min.y - 1;
 
     // decrease this to reduce gas spread. Keep it under 125 for
     // stability. This is essentially a decimal number * 1000.
     const int diffusivity = 100;
 
-    // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( blocks_scent, reduces_scent, scentmap_minx - 1, scentmap_miny - 1,
-                      scentmap_maxx + 1, scentmap_maxy + 1 );
+    // How much of its scent each cell passes on, in tenths: none for cells that block scent,
+    // 20% for REDUCE_SCENT cells and all of it for the others. Computed from the flags without
+    // branching, so this and the following loops can be vectorized.
+    local_array weight;
+    local_array weighted_scent;
+    for( int x = 0; x < width + 2; ++x ) {
+        const auto &blocks = blocks_scent[offset_x + x];
+        const auto &reduces = reduces_scent[offset_x + x];
+        const auto &scent = grscent[offset_x + x];
+        for( int y = 0; y < height + 2; ++y ) {
+            weight[x][y] = ( 1 - blocks[offset_y + y] ) * ( 10 - 8 * reduces[offset_y + y] );
+            weighted_scent[x][y] = weight[x][y] * scent[offset_y + y];
+        }
+    }
+
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
-    // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
-    // note: this method needs an array that is one square larger on each side in the x direction
-    // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
-    // MAPSIZE_X, but if that changes, this may need tweaking.
-    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+    // times. The arrays are indexed [x][y] like grscent, so the inner loops run over
+    // contiguous memory.
+    local_array sum_3_scent_y;
+    local_array squares_used_y;
+    for( int x = 0; x < width + 2; ++x ) {
+        for( int y = 1; y <= height; ++y ) {
             // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            sum_3_scent_y[x][y] = weighted_scent[x][y - 1] + weighted_scent[x][y] +
+                                  weighted_scent[x][y + 1];
+            squares_used_y[x][y] = weight[x][y - 1] + weight[x][y] + weight[x][y + 1];
         }
     }
 
-    // Rest of the scent map
-    for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            auto &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring walls and reduce_scent squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent
-                scent_here = 0;
-            }
+    for( int x = 1; x <= width; ++x ) {
+        auto &scent = grscent[offset_x + x];
+        for( int y = 1; y <= height; ++y ) {
+            const int scent_here = scent[offset_y + y];
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = squares_used_y[x - 1][y] + squares_used_y[x][y] +
+                                     squares_used_y[x + 1][y];
+            // less air movement for REDUCE_SCENT squares
+            const int this_diffusivity = weight[x][y] * ( diffusivity / 10 );
+            // take the old scent and subtract what diffuses out
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            // neighboring walls and reduce_scent squares absorb some scent
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square.
+            const int sum_3_scent = sum_3_scent_y[x - 1][y] + sum_3_scent_y[x][y] +
+                                    sum_3_scent_y[x + 1][y];
+            const int new_scent = ( temp_scent + this_diffusivity * sum_3_scent ) / ( 1000 * 10 );
+            // Cells that block scent lose all of it: the mask has all bits set for the other
+            // cells and none for them.
+            const int open_mask = -static_cast<int>( weight[x][y] != 0 );
+            scent[offset_y + y] = new_scent & open_mask;
         }
     }
+
+    scent_bounds = nonzero_bounds( bounding_union( scent_bounds, area ) );
 }
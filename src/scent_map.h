@@ -12,6 +12,8 @@
 #include "point.h"
 
 static constexpr int SCENT_MAP_Z_REACH = 1;
+/** Scent diffuses up to this distance from the player. */
+static constexpr int SCENT_RADIUS = 40;
 
 class map;
 class game;
@@ -23,18 +25,26 @@ class window;
 
 class scent_map
 {
-    protected:
+    public:
         template<typename T>
         using scent_array = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
 
+    protected:
         scent_array<int> grscent;
+        /**
+         * Smallest rectangle (inclusive) that contains all nonzero scent values, or a larger
+         * one. Empty if its minimum is beyond its maximum.
+         */
+        rectangle scent_bounds;
+        /** Smallest rectangle that contains all nonzero scent values inside @p area. */
+        rectangle nonzero_bounds( const rectangle &area ) const;
         cata::optional<tripoint> player_last_position;
         time_point player_last_moved = calendar::before_time_starts;
 
         const game &gm;
 
     public:
-        scent_map( const game &g ) : gm( g ) { }
+        scent_map( const game &g );
 
         void deserialize( const std::string &data );
         std::string serialize() const;
@@ -42,6 +52,19 @@ class scent_map
         void draw( const catacurses::window &win, int div, const tripoint &center ) const;
 
         void update( const tripoint &center, map &m );
+        /**
+         * The area @ref update diffuses scent in: the part of the square of @ref SCENT_RADIUS
+         * around @p center that contains scent or is next to it. May be empty.
+         */
+        rectangle diffusion_area( const tripoint &center ) const;
+        /**
+         * Diffuses the scent in @p area by one turn, scent outside of it is not changed.
+         * The area must be at most 2 * @ref SCENT_RADIUS + 1 cells wide and high and must not
+         * touch the map edge. @p blocks_scent and @p reduces_scent have to be filled for the
+         * area and the cells bordering it, see @ref map::scent_blockers.
+         */
+        void diffuse( const rectangle &area, const scent_array<bool> &blocks_scent,
+                      const scent_array<bool> &reduces_scent );
         void reset();
         void decay();
         void shift( int sm_shift_x, int sm_shift_y );
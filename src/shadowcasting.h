@@ -12,6 +12,26 @@
 #include "lightmap.h"
 
 struct tripoint;
+class thread_pool;
+
+/**
+ * Whether the shadowcasting kernels may spread their work over several threads.
+ * Cached from the "PARALLEL_SHADOWCASTING" option.
+ */
+extern bool parallel_shadowcasting;
+
+/**
+ * The pool the shadowcasting kernels use in parallel mode, or nullptr if
+ * @ref parallel_shadowcasting is off. The pool may have no worker threads on
+ * single core machines.
+ */
+thread_pool *shadowcasting_pool();
+
+/**
+ * Whether castLightAll uses its table-driven kernel for sight_calc casts. Always on in
+ * the game, the shadowcasting benchmark turns it off to time the generic kernel.
+ */
+extern bool shadowcasting_sight_tables;
 
 // For light we store four values, depending on the direction that the light
 // comes from.  This allows us to determine whether the side of the wall the
@@ -0,0 +1,213 @@
+#include "submap_prefetcher.h"
+
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <utility>
+
+#include "coordinate_conversions.h"
+#include "filesystem.h"
+#include "submap_region.h"
+
+// MinGW without posix threads lacks std::thread, prefetching is disabled there.
+#if !defined(_WIN32) || defined(_MSC_VER)
+#   define CATA_SUBMAP_PREFETCH
+#   include <condition_variable>
+#   include <mutex>
+#   include <thread>
+#endif
+
+struct submap_prefetcher_impl {
+#if defined(CATA_SUBMAP_PREFETCH)
+    struct request {
+        std::string map_directory;
+        tripoint om_addr;
+    };
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<request> pending;
+    // Every quad that has been requested and not taken yet, and the quads without saved data,
+    // which only need to be read again once the saved submaps change.
+    std::set<tripoint> requested;
+    std::map<tripoint, submap_prefetcher::quad> finished;
+    // Incremented by discard, so the worker can tell that the quad it just read is stale.
+    unsigned int generation = 0;
+    bool stopping = false;
+
+    // Region files the worker has opened, by segment. Only the worker touches these.
+    std::map<tripoint, std::unique_ptr<submap_region>> regions;
+    unsigned int regions_generation = 0;
+
+    void read_quad( const request &req, submap_prefetcher::quad &result ) {
+        result.om_addr = req.om_addr;
+        const std::string quad_file = quad_file_path( req.map_directory, req.om_addr );
+        std::ifstream fin( quad_file.c_str(), std::ios::binary );
+        if( fin.is_open() ) {
+            result.quad_file.assign( std::istreambuf_iterator<char>( fin ),
+                                     std::istreambuf_iterator<char>() );
+            return;
+        }
+        const tripoint segment_addr = omt_to_seg_copy( req.om_addr );
+        auto iter = regions.find( segment_addr );
+        if( iter == regions.end() ) {
+            const std::string path = submap_region::path_for( req.map_directory, segment_addr );
+            std::unique_ptr<submap_region> region;
+            if( file_exist( path ) ) {
+                region = std::make_unique<submap_region>( path );
+            }
+            iter = regions.emplace( segment_addr, std::move( region ) ).first;
+        }
+        if( iter->second == nullptr ) {
+            return;
+        }
+        const tripoint sm_addr = omt_to_sm_copy( req.om_addr );
+        for( int x = 0; x < 2; x++ ) {
+            for( int y = 0; y < 2; y++ ) {
+                const tripoint p( sm_addr.x + x, sm_addr.y + y, sm_addr.z );
+                if( iter->second->has( p ) ) {
+                    result.region_records[p] = iter->second->record( p );
+                }
+            }
+        }
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ) {
+            wake.wait( lock, [this]() {
+                return stopping || !pending.empty();
+            } );
+            if( stopping ) {
+                return;
+            }
+            const request req = pending.front();
+            pending.pop_front();
+            const unsigned int read_generation = generation;
+            lock.unlock();
+
+            if( regions_generation != read_generation ) {
+                // Region files may have been rewritten since they were opened.
+                regions.clear();
+                regions_generation = read_generation;
+            }
+            submap_prefetcher::quad result;
+            try {
+                read_quad( req, result );
+            } catch( const std::exception & ) {
+                // Leave it to the main thread to load it again and report the error.
+                result = submap_prefetcher::quad();
+                result.om_addr = req.om_addr;
+            }
+
+            lock.lock();
+            if( generation == read_generation ) {
+                finished[req.om_addr] = std::move( result );
+            }
+        }
+    }
+#endif
+};
+
+submap_prefetcher::submap_prefetcher() : impl( new submap_prefetcher_impl() )
+{
+}
+
+submap_prefetcher::~submap_prefetcher()
+{
+#if defined(CATA_SUBMAP_PREFETCH)
+    if( impl->worker.joinable() ) {
+        {
+            std::lock_guard<std::mutex> lock( impl->mutex );
+            impl->stopping = true;
+        }
+        impl->wake.notify_all();
+        impl->worker.join();
+    }
+#endif
+}
+
+bool submap_prefetcher::available()
+{
+#if defined(CATA_SUBMAP_PREFETCH)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void submap_prefetcher::request( const std::string &map_directory, const tripoint &om_addr )
+{
+#if defined(CATA_SUBMAP_PREFETCH)
+    {
+        std::lock_guard<std::mutex> lock( impl->mutex );
+        if( !impl->requested.insert( om_addr ).second ) {
+            return;
+        }
+        impl->pending.push_back( { map_directory, om_addr } );
+    }
+    if( !impl->worker.joinable() ) {
+        impl->worker = std::thread( &submap_prefetcher_impl::work, impl.get() );
+    }
+    impl->wake.notify_one();
+#else
+    ( void ) map_directory;
+    ( void ) om_addr;
+#endif
+}
+
+bool submap_prefetcher::take( const tripoint &om_addr, quad &result )
+{
+#if defined(CATA_SUBMAP_PREFETCH)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    const auto iter = impl->finished.find( om_addr );
+    if( iter == impl->finished.end() ) {
+        return false;
+    }
+    result = std::move( iter->second );
+    impl->finished.erase( iter );
+    if( !result.quad_file.empty() || !result.region_records.empty() ) {
+        impl->requested.erase( om_addr );
+    }
+    return true;
+#else
+    ( void ) om_addr;
+    ( void ) result;
+    return false;
+#endif
+}
+
+std::vector<submap_prefetcher::quad> submap_prefetcher::take_finished( const int max_quads )
+{
+    std::vector<quad> result;
+#if defined(CATA_SUBMAP_PREFETCH)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    int num_quads = 0;
+    for( auto iter = impl->finished.begin(); iter != impl->finished.end() &&
+         num_quads < max_quads; ) {
+        if( !iter->second.quad_file.empty() || !iter->second.region_records.empty() ) {
+            num_quads++;
+            impl->requested.erase( iter->first );
+            result.push_back( std::move( iter->second ) );
+        }
+        iter = impl->finished.erase( iter );
+    }
+#else
+    ( void ) max_quads;
+#endif
+    return result;
+}
+
+void submap_prefetcher::discard()
+{
+#if defined(CATA_SUBMAP_PREFETCH)
+    std::lock_guard<std::mutex> lock( impl->mutex );
+    impl->pending.clear();
+    impl->requested.clear();
+    impl->finished.clear();
+    impl->generation++;
+#endif
+}
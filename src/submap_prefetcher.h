@@ -0,0 +1,64 @@
+#pragma once
+#ifndef SUBMAP_PREFETCHER_H
+#define SUBMAP_PREFETCHER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "point.h"
+
+struct submap_prefetcher_impl;
+
+/**
+ * Reads saved submap quads from disk on a background thread, so the main thread only
+ * has to decode them when the map reaches them.
+ *
+ * Only the file I/O happens in the background: decoding a submap looks up game data and
+ * interns ids, which is not thread safe, so that is left to @ref mapbuffer on the main thread.
+ */
+class submap_prefetcher
+{
+    public:
+        /** The saved data of one quad, as read from the maps directory. */
+        struct quad {
+            tripoint om_addr;
+            /** Contents of the quad file, empty if there is none. */
+            std::string quad_file;
+            /** Records of the submaps of the quad from the region file, if there was no quad file. */
+            std::map<tripoint, std::string> region_records;
+        };
+
+        submap_prefetcher();
+        ~submap_prefetcher();
+
+        submap_prefetcher( const submap_prefetcher & ) = delete;
+        submap_prefetcher &operator=( const submap_prefetcher & ) = delete;
+
+        /** Whether requests are read at all. False on platforms without threads. */
+        static bool available();
+
+        /**
+         * Queues reading the quad @p om_addr from the maps directory @p map_directory,
+         * unless it has been requested since it was last taken.
+         */
+        void request( const std::string &map_directory, const tripoint &om_addr );
+        /** Takes the data of the quad @p om_addr if it has been read. */
+        bool take( const tripoint &om_addr, quad &result );
+        /**
+         * Takes the data of up to @p max_quads quads that have been read. Quads without
+         * saved data are dropped, they are not read again until @ref discard.
+         */
+        std::vector<quad> take_finished( int max_quads );
+        /**
+         * Forgets all requests and all data read so far. Must be called before the saved
+         * submaps change, data read before that is never returned afterwards.
+         */
+        void discard();
+
+    private:
+        std::unique_ptr<submap_prefetcher_impl> impl;
+};
+
+#endif
@@ -0,0 +1,359 @@
+#include "submap_region.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "cata_utility.h"
+#include "coordinate_conversions.h"
+#include "filesystem.h"
+#include "json.h"
+#include "string_formatter.h"
+
+const char submap_region::magic[8] = { 'C', 'D', 'D', 'A', 'M', 'A', 'P', 'R' };
+constexpr uint32_t submap_region::format_version;
+
+static constexpr size_t header_size_v1 = sizeof( submap_region::magic ) + 4 + 4;
+static constexpr size_t header_size = header_size_v1 + 8;
+static constexpr size_t index_entry_size = 4 + 4 + 4 + 8 + 4;
+
+static uint64_t read_le( const char *data, const int bytes )
+{
+    uint64_t result = 0;
+    for( int i = bytes - 1; i >= 0; i-- ) {
+        result = ( result << 8 ) | static_cast<unsigned char>( data[i] );
+    }
+    return result;
+}
+
+static void write_le( std::string &out, const uint64_t value, const int bytes )
+{
+    for( int i = 0; i < bytes; i++ ) {
+        out.push_back( static_cast<char>( ( value >> ( i * 8 ) ) & 0xff ) );
+    }
+}
+
+submap_region::submap_region( const std::string &path ) : file( path )
+{
+    const char *const data = file.data();
+    if( file.size() < header_size_v1 ||
+        !std::equal( std::begin( magic ), std::end( magic ), data ) ) {
+        throw std::runtime_error( string_format( "%s is not a map region file", path ) );
+    }
+    version = read_le( data + 8, 4 );
+    if( version != 1 && version != format_version ) {
+        throw std::runtime_error( string_format( "%s has unknown map region format version %d",
+                                  path, version ) );
+    }
+    const uint32_t count = read_le( data + 12, 4 );
+    uint64_t index_offset = header_size_v1;
+    if( version != 1 ) {
+        if( file.size() < header_size ) {
+            throw std::runtime_error( string_format( "header of %s is truncated", path ) );
+        }
+        index_offset = read_le( data + 16, 8 );
+    }
+    if( index_offset > file.size() ||
+        ( file.size() - index_offset ) / index_entry_size < count ) {
+        throw std::runtime_error( string_format( "index of %s is truncated", path ) );
+    }
+    for( uint32_t i = 0; i < count; i++ ) {
+        const char *const raw = data + index_offset + i * index_entry_size;
+        const tripoint submap_addr( static_cast<int32_t>( read_le( raw, 4 ) ),
+                                    static_cast<int32_t>( read_le( raw + 4, 4 ) ),
+                                    static_cast<int32_t>( read_le( raw + 8, 4 ) ) );
+        const entry record_entry{ read_le( raw + 12, 8 ),
+                                  static_cast<uint32_t>( read_le( raw + 20, 4 ) ) };
+        if( record_entry.offset > file.size() ||
+            record_entry.size > file.size() - record_entry.offset ) {
+            throw std::runtime_error( string_format( "record of submap %d,%d,%d in %s is truncated",
+                                      submap_addr.x, submap_addr.y, submap_addr.z, path ) );
+        }
+        index[submap_addr] = record_entry;
+    }
+}
+
+std::string submap_region::path_for( const std::string &map_directory,
+                                     const tripoint &segment_addr )
+{
+    return string_format( "%s/%d.%d.%d.region", map_directory, segment_addr.x, segment_addr.y,
+                          segment_addr.z );
+}
+
+bool submap_region::has( const tripoint &submap_addr ) const
+{
+    return index.count( submap_addr ) != 0;
+}
+
+std::string submap_region::record( const tripoint &submap_addr ) const
+{
+    const auto iter = index.find( submap_addr );
+    if( iter == index.end() ) {
+        return std::string();
+    }
+    return std::string( file.data() + iter->second.offset, iter->second.size );
+}
+
+bool submap_region::has_record( const tripoint &submap_addr, const std::string &record ) const
+{
+    const auto iter = index.find( submap_addr );
+    return iter != index.end() && iter->second.size == record.size() &&
+           std::equal( record.begin(), record.end(), file.data() + iter->second.offset );
+}
+
+void submap_region::get_records( std::map<tripoint, std::string> &records ) const
+{
+    for( const auto &elem : index ) {
+        if( records.count( elem.first ) == 0 ) {
+            records[elem.first] = record( elem.first );
+        }
+    }
+}
+
+void submap_region::write_index( std::string &out, const std::map<tripoint, entry> &index )
+{
+    for( const auto &elem : index ) {
+        write_le( out, static_cast<uint32_t>( elem.first.x ), 4 );
+        write_le( out, static_cast<uint32_t>( elem.first.y ), 4 );
+        write_le( out, static_cast<uint32_t>( elem.first.z ), 4 );
+        write_le( out, elem.second.offset, 8 );
+        write_le( out, elem.second.size, 4 );
+    }
+}
+
+void submap_region::write( std::ostream &out, const std::map<tripoint, std::string> &records )
+{
+    std::map<tripoint, entry> records_index;
+    uint64_t offset = header_size;
+    for( const auto &elem : records ) {
+        records_index[elem.first] = entry{ offset, static_cast<uint32_t>( elem.second.size() ) };
+        offset += elem.second.size();
+    }
+    std::string header( std::begin( magic ), std::end( magic ) );
+    write_le( header, format_version, 4 );
+    write_le( header, records.size(), 4 );
+    write_le( header, offset, 8 );
+    out.write( header.data(), header.size() );
+    for( const auto &elem : records ) {
+        out.write( elem.second.data(), elem.second.size() );
+    }
+    std::string index_data;
+    write_index( index_data, records_index );
+    out.write( index_data.data(), index_data.size() );
+}
+
+void submap_region::write( const std::string &path, const std::map<tripoint, std::string> &records )
+{
+    const std::string temp_path = path + ".temp";
+    {
+        ofstream_wrapper_exclusive fout( temp_path );
+        write( fout.stream(), records );
+        fout.close();
+    }
+    if( !rename_file( temp_path, path ) ) {
+        remove_file( temp_path );
+        throw std::runtime_error( string_format( "replacing %s failed", path ) );
+    }
+}
+
+void submap_region::append( const std::string &path,
+                            const std::map<tripoint, std::string> &records )
+{
+    if( records.empty() ) {
+        return;
+    }
+    std::map<tripoint, entry> new_index;
+    uint64_t file_size = 0;
+    uint64_t index_offset = 0;
+    // All records, if the file gets rewritten instead.
+    std::map<tripoint, std::string> all_records;
+    {
+        const submap_region region( path );
+        new_index = region.index;
+        file_size = region.file.size();
+        index_offset = file_size;
+        for( const auto &elem : records ) {
+            new_index[elem.first] = entry{ index_offset,
+                                           static_cast<uint32_t>( elem.second.size() ) };
+            index_offset += elem.second.size();
+        }
+        const uint64_t index_size = new_index.size() * index_entry_size;
+        uint64_t used = header_size + index_size;
+        for( const auto &elem : new_index ) {
+            used += elem.second.size;
+        }
+        const uint64_t unused = index_offset + index_size - used;
+        if( region.version != format_version || unused > used ) {
+            all_records = records;
+            region.get_records( all_records );
+        }
+    }
+    if( !all_records.empty() ) {
+        write( path, all_records );
+        return;
+    }
+
+    std::fstream fout( path.c_str(), std::ios::binary | std::ios::in | std::ios::out );
+    if( !fout.is_open() ) {
+        throw std::runtime_error( string_format( "opening %s failed", path ) );
+    }
+    fout.seekp( file_size );
+    for( const auto &elem : records ) {
+        fout.write( elem.second.data(), elem.second.size() );
+    }
+    std::string index_data;
+    write_index( index_data, new_index );
+    fout.write( index_data.data(), index_data.size() );
+    fout.flush();
+    if( fout.fail() ) {
+        throw std::runtime_error( string_format( "appending to %s failed", path ) );
+    }
+    // Only now point the header to the new index.
+    std::string header_tail;
+    write_le( header_tail, new_index.size(), 4 );
+    write_le( header_tail, index_offset, 8 );
+    fout.seekp( sizeof( magic ) + 4 );
+    fout.write( header_tail.data(), header_tail.size() );
+    fout.close();
+    if( fout.fail() ) {
+        throw std::runtime_error( string_format( "updating the index of %s failed", path ) );
+    }
+}
+
+static std::string segment_directory( const std::string &map_directory, const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    return string_format( "%s/%d.%d.%d", map_directory, segment_addr.x, segment_addr.y,
+                          segment_addr.z );
+}
+
+std::string quad_file_path( const std::string &map_directory, const tripoint &om_addr )
+{
+    return string_format( "%s/%d.%d.%d.map", segment_directory( map_directory, om_addr ),
+                          om_addr.x, om_addr.y, om_addr.z );
+}
+
+// Reads the coordinates member of a record.
+static tripoint record_coordinates( const std::string &record )
+{
+    std::istringstream stream( record );
+    JsonIn jsin( stream );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        if( jsin.get_member_name() != "coordinates" ) {
+            jsin.skip_value();
+            continue;
+        }
+        jsin.start_array();
+        const int x = jsin.get_int();
+        const int y = jsin.get_int();
+        const int z = jsin.get_int();
+        jsin.end_array();
+        return tripoint( x, y, z );
+    }
+    jsin.error( "submap without coordinates" );
+}
+
+// Splits the contents of a quad file into the records of its submaps, without decoding them.
+static void split_quad( const std::string &contents, std::map<tripoint, std::string> &records )
+{
+    std::istringstream stream( contents );
+    JsonIn jsin( stream );
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        jsin.eat_whitespace();
+        const int start = jsin.tell();
+        jsin.skip_value();
+        // skip_value also consumes the separator after the object.
+        std::string record = contents.substr( start, jsin.tell() - start );
+        record.erase( record.find_last_of( '}' ) + 1 );
+        const tripoint submap_addr = record_coordinates( record );
+        records[submap_addr] = std::move( record );
+    }
+}
+
+int convert_quads_to_regions( const std::string &map_directory )
+{
+    // Records of each segment, so every region file is written only once.
+    std::map<tripoint, std::map<tripoint, std::string>> segments;
+    std::vector<std::string> converted_files;
+    for( const std::string &path : get_files_from_path( ".map", map_directory, true, true ) ) {
+        std::map<tripoint, std::string> records;
+        const bool read = read_from_file( path, [&]( std::istream & fin ) {
+            const std::string contents( ( std::istreambuf_iterator<char>( fin ) ),
+                                        std::istreambuf_iterator<char>() );
+            split_quad( contents, records );
+        } );
+        if( !read ) {
+            continue;
+        }
+        for( auto &elem : records ) {
+            const tripoint segment_addr = omt_to_seg_copy( sm_to_omt_copy( elem.first ) );
+            segments[segment_addr][elem.first] = std::move( elem.second );
+        }
+        converted_files.push_back( path );
+    }
+
+    int converted = 0;
+    for( auto &segment : segments ) {
+        const std::string path = submap_region::path_for( map_directory, segment.first );
+        if( file_exist( path ) ) {
+            submap_region( path ).get_records( segment.second );
+        }
+        submap_region::write( path, segment.second );
+        converted += segment.second.size();
+    }
+    std::set<std::string> directories;
+    for( const std::string &path : converted_files ) {
+        remove_file( path );
+        directories.insert( path.substr( 0, path.find_last_of( '/' ) ) );
+    }
+    // Only removes the segment directories that are empty now.
+    for( const std::string &dir : directories ) {
+        remove_directory( dir );
+    }
+    return converted;
+}
+
+int convert_regions_to_quads( const std::string &map_directory )
+{
+    int converted = 0;
+    for( const std::string &path : get_files_from_path( ".region", map_directory, false, true ) ) {
+        std::map<tripoint, std::map<tripoint, std::string>> quads;
+        {
+            const submap_region region( path );
+            std::map<tripoint, std::string> records;
+            region.get_records( records );
+            for( auto &elem : records ) {
+                quads[sm_to_omt_copy( elem.first )][elem.first] = std::move( elem.second );
+            }
+        }
+        for( const auto &quad : quads ) {
+            const std::string quad_file = quad_file_path( map_directory, quad.first );
+            if( file_exist( quad_file ) ) {
+                continue;
+            }
+            assure_dir_exist( segment_directory( map_directory, quad.first ) );
+            ofstream_wrapper_exclusive fout( quad_file );
+            fout.stream() << '[';
+            bool first = true;
+            for( const auto &elem : quad.second ) {
+                if( !first ) {
+                    fout.stream() << ',';
+                }
+                first = false;
+                fout.stream() << elem.second;
+            }
+            fout.stream() << ']';
+            fout.close();
+            converted += quad.second.size();
+        }
+        remove_file( path );
+    }
+    return converted;
+}
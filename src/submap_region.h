@@ -0,0 +1,108 @@
+#pragma once
+#ifndef SUBMAP_REGION_H
+#define SUBMAP_REGION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+#include "filesystem.h"
+#include "point.h"
+
+/**
+ * A region file holds all saved submaps of one map segment (SEG_SIZE x SEG_SIZE overmap terrain
+ * quads, the same grouping the maps/ directory uses for its subdirectories) in a single file,
+ * instead of one JSON file per quad.
+ *
+ * Layout of version 2, all integers little endian:
+ * - the 8 bytes of @ref submap_region::magic,
+ * - uint32 format version, uint32 number of submaps, uint64 offset of the index,
+ * - the records,
+ * - the index, one entry per submap: int32 x, y, z of the submap (absolute submap
+ *   coordinates), uint64 offset of its record from the start of the file, uint32 size of
+ *   its record.
+ * Version 1 files have no index offset in the header, their index follows it directly.
+ *
+ * A record is the JSON object the quad files store for that submap (savegame version,
+ * coordinates and the submap itself), so the submap schema and its migrations stay in
+ * submap::store and submap::load. Only the index is read when the file is opened, records
+ * are decoded one submap at a time when they are needed.
+ *
+ * Because the index comes last, changed records can be appended to the file together with
+ * a new index, see @ref append. The records and the index they replace stay in the file as
+ * unused space until it gets rewritten.
+ */
+class submap_region
+{
+    public:
+        static const char magic[8];
+        static constexpr uint32_t format_version = 2;
+
+        /** Opens and maps the region file at @p path. Throws std::runtime_error if invalid. */
+        explicit submap_region( const std::string &path );
+
+        /** Path of the region file of segment @p segment_addr in the maps directory. */
+        static std::string path_for( const std::string &map_directory,
+                                     const tripoint &segment_addr );
+
+        bool has( const tripoint &submap_addr ) const;
+        /** The record of the submap at @p submap_addr, or an empty string if the file lacks it. */
+        std::string record( const tripoint &submap_addr ) const;
+        /** Whether the file has the record @p record for the submap at @p submap_addr. */
+        bool has_record( const tripoint &submap_addr, const std::string &record ) const;
+        /** Copies all records of this file into @p records, keeping the ones already in there. */
+        void get_records( std::map<tripoint, std::string> &records ) const;
+        size_t size() const {
+            return index.size();
+        }
+
+        /**
+         * Writes @p records into a region file at @p path. The file is written next to its
+         * destination and then renamed over it, so the old file stays intact if writing fails.
+         * Throws std::runtime_error on failure.
+         */
+        static void write( const std::string &path,
+                           const std::map<tripoint, std::string> &records );
+        /** Writes a region file containing @p records into @p out. */
+        static void write( std::ostream &out, const std::map<tripoint, std::string> &records );
+        /**
+         * Adds @p records to the region file at @p path, replacing the records of the same
+         * submaps. They are appended with a new index, and the header is changed last to point
+         * to it, so the old contents stay readable if writing fails. The file is rewritten
+         * instead if that leaves more unused than used space in it, or if it has an older
+         * format version. Throws std::runtime_error on failure.
+         */
+        static void append( const std::string &path,
+                            const std::map<tripoint, std::string> &records );
+
+    private:
+        struct entry {
+            uint64_t offset;
+            uint32_t size;
+        };
+        static void write_index( std::string &out, const std::map<tripoint, entry> &index );
+
+        mapped_file file;
+        uint32_t version;
+        std::map<tripoint, entry> index;
+};
+
+/** Path of the quad file of the overmap terrain @p om_addr in the maps directory. */
+std::string quad_file_path( const std::string &map_directory, const tripoint &om_addr );
+
+/**
+ * Converts all quad files in the maps directory @p map_directory into region files and
+ * removes them. Submaps that are already in a region file are replaced.
+ * @return The number of converted submaps.
+ */
+int convert_quads_to_regions( const std::string &map_directory );
+/**
+ * Converts all region files in the maps directory @p map_directory into quad files and
+ * removes them. Existing quad files are kept, they are newer than the region records.
+ * @return The number of converted submaps.
+ */
+int convert_regions_to_quads( const std::string &map_directory );
+
+#endif
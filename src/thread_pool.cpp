@@ -0,0 +1,126 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+// MinGW without posix threads lacks std::thread, the pool runs everything on the
+// calling thread there.
+#if !defined(_WIN32) || defined(_MSC_VER)
+#   define CATA_THREAD_POOL_WORKERS
+#   include <condition_variable>
+#   include <mutex>
+#   include <thread>
+#endif
+
+struct thread_pool_impl {
+#if defined(CATA_THREAD_POOL_WORKERS)
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable batch_started;
+    std::condition_variable batch_finished;
+    const std::function<void( int )> *task = nullptr;
+    int num_tasks = 0;
+    int next_task = 0;
+    int unfinished_tasks = 0;
+    // Incremented for every batch, so sleeping workers can tell a new batch from a spurious wakeup.
+    unsigned int batch = 0;
+    bool stopping = false;
+
+    // Takes tasks of the current batch until there are none left. Must be called with the lock held.
+    void work_on_batch( std::unique_lock<std::mutex> &lock ) {
+        while( next_task < num_tasks ) {
+            const int index = next_task++;
+            const std::function<void( int )> &current = *task;
+            lock.unlock();
+            current( index );
+            lock.lock();
+            if( --unfinished_tasks == 0 ) {
+                batch_finished.notify_all();
+            }
+        }
+    }
+
+    void work() {
+        unsigned int seen_batch = 0;
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ) {
+            batch_started.wait( lock, [&]() {
+                return stopping || batch != seen_batch;
+            } );
+            if( stopping ) {
+                return;
+            }
+            seen_batch = batch;
+            work_on_batch( lock );
+        }
+    }
+#endif
+};
+
+thread_pool::thread_pool( const int num_workers ) : impl( new thread_pool_impl() )
+{
+#if defined(CATA_THREAD_POOL_WORKERS)
+    for( int i = 0; i < num_workers; i++ ) {
+        impl->workers.emplace_back( &thread_pool_impl::work, impl.get() );
+    }
+#else
+    ( void ) num_workers;
+#endif
+}
+
+thread_pool::~thread_pool()
+{
+#if defined(CATA_THREAD_POOL_WORKERS)
+    {
+        std::lock_guard<std::mutex> lock( impl->mutex );
+        impl->stopping = true;
+    }
+    impl->batch_started.notify_all();
+    for( std::thread &worker : impl->workers ) {
+        worker.join();
+    }
+#endif
+}
+
+int thread_pool::hardware_threads()
+{
+#if defined(CATA_THREAD_POOL_WORKERS)
+    return std::max( 1, static_cast<int>( std::thread::hardware_concurrency() ) );
+#else
+    return 1;
+#endif
+}
+
+int thread_pool::size() const
+{
+#if defined(CATA_THREAD_POOL_WORKERS)
+    return static_cast<int>( impl->workers.size() ) + 1;
+#else
+    return 1;
+#endif
+}
+
+void thread_pool::run( const int num_tasks, const std::function<void( int )> &task )
+{
+#if defined(CATA_THREAD_POOL_WORKERS)
+    if( num_tasks > 1 && !impl->workers.empty() ) {
+        std::unique_lock<std::mutex> lock( impl->mutex );
+        impl->task = &task;
+        impl->num_tasks = num_tasks;
+        impl->next_task = 0;
+        impl->unfinished_tasks = num_tasks;
+        impl->batch++;
+        impl->batch_started.notify_all();
+        impl->work_on_batch( lock );
+        impl->batch_finished.wait( lock, [&]() {
+            return impl->unfinished_tasks == 0;
+        } );
+        impl->task = nullptr;
+        impl->num_tasks = 0;
+        return;
+    }
+#endif
+    for( int i = 0; i < num_tasks; i++ ) {
+        task( i );
+    }
+}
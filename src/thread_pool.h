@@ -0,0 +1,45 @@
+#pragma once
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <functional>
+#include <memory>
+
+struct thread_pool_impl;
+
+/**
+ * A fixed set of worker threads that run batches of independent tasks.
+ *
+ * A batch is started with @ref run, which returns once every task of the batch has
+ * finished. The calling thread works on the batch as well, so a pool without any
+ * workers simply runs the tasks in order on the calling thread.
+ *
+ * Only one thread may start batches on a pool, and tasks must not start batches
+ * on the pool that runs them.
+ */
+class thread_pool
+{
+    public:
+        /** Starts @p num_workers threads in addition to the thread that calls @ref run. */
+        explicit thread_pool( int num_workers );
+        ~thread_pool();
+
+        thread_pool( const thread_pool & ) = delete;
+        thread_pool &operator=( const thread_pool & ) = delete;
+
+        /** Number of threads the hardware can run at once, at least 1. */
+        static int hardware_threads();
+
+        /** Number of threads that work on a batch, including the one calling @ref run. */
+        int size() const;
+        /**
+         * Calls @p task once for every index in [0, @p num_tasks), in no particular order
+         * and possibly concurrently. Returns once all calls have returned.
+         */
+        void run( int num_tasks, const std::function<void( int )> &task );
+
+    private:
+        std::unique_ptr<thread_pool_impl> impl;
+};
+
+#endif
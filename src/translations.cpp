@@ -35,6 +35,13 @@ static void reload_names()
 
 static bool sanity_checked_genders = false;
 
+static int language_version = 0;
+
+int get_language_version()
+{
+    return language_version;
+}
+
 #if defined(LOCALIZE)
 #include "options.h"
 #include "debug.h"
@@ -221,6 +228,7 @@ void set_language()
     textdomain( "cataclysm-dda" );
 
     reload_names();
+    language_version++;
 
     sanity_checked_genders = false;
 }
@@ -284,6 +292,7 @@ void select_language()
 void set_language()
 {
     reload_names();
+    language_version++;
     return;
 }
 
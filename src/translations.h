@@ -106,6 +106,8 @@ bool isValidLanguage( const std::string &lang );
 std::string getLangFromLCID( const int &lcid );
 void select_language();
 void set_language();
+/** Changes whenever the language is set, so translated texts kept elsewhere can be updated. */
+int get_language_version();
 
 class JsonIn;
 
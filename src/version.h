@@ -0,0 +1 @@
+#define VERSION "210419c"
@@ -154,11 +154,19 @@ bool visitable<T>::has_quality( const quality_id &qual, int level, int qty ) con
 template <>
 bool visitable<inventory>::has_quality( const quality_id &qual, int level, int qty ) const
 {
+    const auto &binned = static_cast<const inventory *>( this )->get_binned_qualities();
+    const auto iter = binned.find( qual );
+    if( iter == binned.end() ) {
+        return false;
+    }
+
     int res = 0;
-    for( const auto &stack : static_cast<const inventory *>( this )->items ) {
-        res += stack.size() * has_quality_internal( stack.front(), qual, level, qty );
-        if( res >= qty ) {
-            return true;
+    for( const std::pair<const item *, int> &e : iter->second ) {
+        if( e.first->get_quality( qual ) >= level ) {
+            res = sum_no_wrap( res, e.second * static_cast<int>( e.first->count() ) );
+            if( res >= qty ) {
+                return true;
+            }
         }
     }
     return false;
@@ -547,6 +555,8 @@ std::list<item> visitable<inventory>::remove_items_with( const
     if( count <= 0 ) {
         return res; // nothing to do
     }
+    // The binned items may point to the removed items.
+    inv->unsort();
 
     for( auto stack = inv->items.begin(); stack != inv->items.end() && count > 0; ) {
         std::list<item> &istack = *stack;
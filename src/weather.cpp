@@ -1040,4 +1040,28 @@ void weather_manager::clear_temp_cache()
     temperature_cache.clear();
 }
 
+double weather_manager::get_weather_temperature( const tripoint &location, const time_point &time )
+{
+    const weather_generator &wgen = get_cur_weather_gen();
+    const unsigned seed = g->get_seed();
+    // Enough for a few thousand places with a few days of history each.
+    static constexpr size_t max_cached = 100000;
+    if( &wgen != weather_cache_generator || seed != weather_cache_seed ||
+        weather_temperature_cache.size() >= max_cached ) {
+        weather_temperature_cache.clear();
+        weather_cache_generator = &wgen;
+        weather_cache_seed = seed;
+    }
+    const weather_cache_key key{ location.x, location.y, to_turn<int>( time ) };
+    weather_temperature_cache_stats.lookups++;
+    const auto cached = weather_temperature_cache.find( key );
+    if( cached != weather_temperature_cache.end() ) {
+        weather_temperature_cache_stats.hits++;
+        return cached->second;
+    }
+    const double temp = wgen.get_weather( location, time, seed ).temperature;
+    weather_temperature_cache.emplace( key, temp );
+    return temp;
+}
+
 ///@}
@@ -232,6 +232,44 @@ class weather_manager
         // Returns outdoor or indoor temperature of given location (in absolute (@ref map::getabs))
         int get_temperature( const tripoint &location );
         void clear_temp_cache();
+        /**
+         * Outdoor temperature the weather generator gives for @p location at @p time, see
+         * @ref weather_generator::get_weather. The results are kept, items on one tile that
+         * catch up on the time they spent outside of the reality bubble together look up the
+         * same turns over and over.
+         */
+        double get_weather_temperature( const tripoint &location, const time_point &time );
+
+        struct weather_cache_stats {
+            int lookups = 0;
+            int hits = 0;
+        };
+        /** How well @ref get_weather_temperature did so far. */
+        const weather_cache_stats &get_weather_temperature_cache_stats() const {
+            return weather_temperature_cache_stats;
+        }
+    private:
+        /** The weather doesn't depend on z. */
+        struct weather_cache_key {
+            int x;
+            int y;
+            int turn;
+
+            bool operator==( const weather_cache_key &rhs ) const {
+                return x == rhs.x && y == rhs.y && turn == rhs.turn;
+            }
+        };
+        struct weather_cache_key_hash {
+            size_t operator()( const weather_cache_key &k ) const {
+                return std::hash<tripoint>()( tripoint( k.x, k.y, k.turn ) );
+            }
+        };
+        std::unordered_map<weather_cache_key, double, weather_cache_key_hash>
+        weather_temperature_cache;
+        /** What the cached weather temperatures were generated with. */
+        const weather_generator *weather_cache_generator = nullptr;
+        unsigned weather_cache_seed = 0;
+        weather_cache_stats weather_temperature_cache_stats;
 };
 
 #endif
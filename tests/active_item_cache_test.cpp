@@ -0,0 +1,101 @@
+#include <list>
+#include <vector>
+
+#include "active_item_cache.h"
+#include "calendar.h"
+#include "catch/catch.hpp"
+#include "item.h"
+
+static std::vector<item *> due_items( active_item_cache &cache )
+{
+    std::vector<item *> result;
+    for( const item_reference &ref : cache.get_for_processing() ) {
+        result.push_back( ref.item_ref.get() );
+    }
+    return result;
+}
+
+static void set_time( const time_point &time )
+{
+    calendar::turn = to_turn<int>( time );
+}
+
+TEST_CASE( "active_items_sleep_until_they_need_processing", "[item]" )
+{
+    const time_point start = calendar::turn;
+    std::list<item> items;
+    item &lamp = *items.emplace( items.end(), "oil_lamp" );
+    lamp.activate();
+    item &meat = *items.emplace( items.end(), "meat_cooked" );
+    meat.set_item_temperature( 300 );
+    meat.reset_temp_check();
+
+    active_item_cache cache;
+    cache.add( lamp, point_zero );
+    cache.add( meat, point_east );
+    cache.add( lamp, point_zero );
+    CHECK( cache.get().size() == 2 );
+
+    // The meat has just been processed, so only the lamp is due.
+    CHECK( due_items( cache ) == std::vector<item *>( { &lamp } ) );
+    calendar::turn += 1;
+    CHECK( due_items( cache ) == std::vector<item *>( { &lamp } ) );
+
+    set_time( start + 10_minutes );
+    CHECK( due_items( cache ).size() == 2 );
+    // Processing it would have updated the temperature.
+    meat.reset_temp_check();
+    calendar::turn += 1;
+    CHECK( due_items( cache ) == std::vector<item *>( { &lamp } ) );
+
+    cache.remove( &lamp );
+    calendar::turn += 1;
+    CHECK( due_items( cache ).empty() );
+    CHECK( cache.get().size() == 1 );
+
+    // Setting the time back wakes the meat up.
+    set_time( start );
+    meat.reset_temp_check();
+    set_time( start - 1_hours );
+    CHECK( due_items( cache ) == std::vector<item *>( { &meat } ) );
+
+    items.clear();
+    CHECK( cache.get().empty() );
+    CHECK( cache.empty() );
+    set_time( start );
+}
+
+TEST_CASE( "active_item_cache_tracks_sleeping_items", "[item]" )
+{
+    std::list<item> items;
+    item &lamp = *items.emplace( items.end(), "oil_lamp" );
+    lamp.activate();
+    item &meat = *items.emplace( items.end(), "meat_cooked" );
+    meat.set_item_temperature( 300 );
+    meat.reset_temp_check();
+
+    active_item_cache cache;
+    cache.add( lamp, point_zero );
+    cache.add( meat, point_east );
+
+    // The sleeping meat is found in its bucket, and can be added again after being removed.
+    cache.remove( &meat );
+    CHECK( cache.get().size() == 1 );
+    cache.remove( &meat );
+    cache.add( meat, point_east );
+    cache.add( meat, point_east );
+    CHECK( cache.get().size() == 2 );
+
+    // A destroyed item is dropped once its bucket is due, a new one can take its place.
+    items.pop_front();
+    CHECK( due_items( cache ).empty() );
+    item &new_lamp = *items.emplace( items.end(), "oil_lamp" );
+    new_lamp.activate();
+    cache.add( new_lamp, point_zero );
+    CHECK( due_items( cache ) == std::vector<item *>( { &new_lamp } ) );
+    CHECK( cache.get().size() == 2 );
+
+    cache.remove( &meat );
+    cache.remove( &new_lamp );
+    CHECK( cache.empty() );
+}
@@ -10,9 +10,11 @@
 #include "avatar.h"
 #include "catch/catch.hpp"
 #include "game.h"
+#include "game_constants.h"
 #include "itype.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "map_iterator.h"
 #include "npc.h"
 #include "player.h"
 #include "player_helpers.h"
@@ -114,6 +116,49 @@ TEST_CASE( "recipe_subset" )
     }
 }
 
+TEST_CASE( "recipe_subset_search", "[recipes]" )
+{
+    recipe_subset all;
+    for( const auto &e : recipe_dict ) {
+        all.include( &e.second );
+    }
+    const recipe_subset rum = all.reduce( "rum" );
+    CHECK( rum.contains( &recipe_id( "brew_rum" ).obj() ) );
+
+    const std::vector<std::pair<std::string, recipe_subset::search_type>> queries = {
+        { "RUM", recipe_subset::search_type::name },
+        { "", recipe_subset::search_type::name },
+        { "wat", recipe_subset::search_type::component },
+        { "tongs", recipe_subset::search_type::tool },
+        { "cutting", recipe_subset::search_type::quality },
+        { "cook", recipe_subset::search_type::skill },
+        { "fabrication", recipe_subset::search_type::primary_skill },
+        { "boil", recipe_subset::search_type::quality_result },
+    };
+    for( const auto &query : queries ) {
+        CAPTURE( query.first );
+        const std::vector<const recipe *> found = all.search( query.first, query.second );
+        CHECK_FALSE( found.empty() );
+        // Searching a subset finds only the recipes in it.
+        CHECK( rum.search( query.first, query.second ).size() <= rum.size() );
+        for( const recipe *r : found ) {
+            CHECK( all.contains( r ) );
+        }
+        CHECK( std::is_sorted( found.begin(), found.end(), std::less<const recipe *>() ) );
+    }
+    CHECK( all.search( "no recipe has this", recipe_subset::search_type::name ).empty() );
+
+    std::vector<const recipe *> expected;
+    for( const recipe *r : all ) {
+        if( *r && !r->obsolete && lcmatch( r->result_name(), "RUM" ) ) {
+            expected.push_back( r );
+        }
+    }
+    CHECK( all.search( "RUM" ) == expected );
+    CHECK( rum.search( "wat", recipe_subset::search_type::component ).size() ==
+           rum.reduce( "wat", recipe_subset::search_type::component ).size() );
+}
+
 TEST_CASE( "available_recipes", "[recipes]" )
 {
     const recipe *r = &recipe_id( "brew_mead" ).obj();
@@ -522,3 +567,95 @@ TEST_CASE( "crafting_interruption" )
         }
     }
 }
+
+TEST_CASE( "crafting_inventory_of_a_storage_room", "[crafting][inventory]" )
+{
+    clear_player();
+    clear_map();
+    const tripoint test_origin( 60, 60, 0 );
+    g->u.setpos( test_origin );
+
+    int tiles = 0;
+    for( const tripoint &p : g->m.points_in_radius( test_origin, PICKUP_RANGE ) ) {
+        g->m.add_item( p, item( "rock" ) );
+        g->m.add_item( p, item( "pot" ) );
+        tiles++;
+    }
+    // A pot with water in it can't be used to boil something else.
+    item water_pot( "pot" );
+    water_pot.put_in( item( "water_clean", calendar::turn, 2 ) );
+    g->m.add_item( test_origin, water_pot );
+
+    g->u.invalidate_crafting_inventory();
+    const inventory &crafting_inv = g->u.crafting_inventory();
+    int rock_stacks = 0;
+    for( const std::list<item> *stack : crafting_inv.const_slice() ) {
+        if( stack->front().typeId() == "rock" ) {
+            rock_stacks++;
+            CHECK( static_cast<int>( stack->size() ) == tiles );
+        }
+    }
+    CHECK( rock_stacks == 1 );
+    CHECK( crafting_inv.amount_of( "pot" ) == tiles + 1 );
+    CHECK( crafting_inv.has_quality( quality_id( "BOIL" ), 2, tiles ) );
+    CHECK_FALSE( crafting_inv.has_quality( quality_id( "BOIL" ), 2, tiles + 1 ) );
+    CHECK_FALSE( crafting_inv.has_quality( quality_id( "BOIL" ), 3 ) );
+    CHECK( crafting_inv.has_quality( quality_id( "COOK" ), 3, tiles + 1 ) );
+
+    inventory copy = crafting_inv;
+    copy.remove_items_with( []( const item & e ) {
+        return e.typeId() == "pot" && e.contents.empty();
+    } );
+    CHECK_FALSE( copy.has_quality( quality_id( "BOIL" ), 2 ) );
+    CHECK( copy.has_quality( quality_id( "COOK" ), 3 ) );
+    CHECK( crafting_inv.has_quality( quality_id( "BOIL" ), 2, tiles ) );
+}
+
+TEST_CASE( "recipe_requirements_checked_together", "[crafting]" )
+{
+    clear_player();
+    clear_map();
+    const tripoint test_origin( 60, 60, 0 );
+    g->u.setpos( test_origin );
+    const std::vector<std::string> tools = {
+        "hammer", "screwdriver", "pot", "hotplate", "knife_butcher"
+    };
+    for( const std::string &tool : tools ) {
+        g->m.add_item( test_origin, item( tool, calendar::turn ) );
+    }
+    g->m.add_item( test_origin, item( "rag", calendar::turn, 10 ) );
+    g->u.invalidate_crafting_inventory();
+
+    const inventory &crafting_inv = g->u.crafting_inventory();
+    int available = 0;
+    const recipe *unavailable = nullptr;
+    for( const auto &e : recipe_dict ) {
+        const recipe &r = e.second;
+        // Obsolete recipes may produce items that no longer exist.
+        if( r.obsolete ) {
+            continue;
+        }
+        const bool expected = r.requirements().can_make_with_inventory( crafting_inv,
+                              r.get_component_filter() );
+        const std::vector<available_status> flags = r.requirements().get_availability();
+        CAPTURE( r.ident().str() );
+        CHECK( g->u.is_recipe_available( r ) == expected );
+        // Checking another batch size changes the flags, the cached answer restores them.
+        r.requirements().can_make_with_inventory( crafting_inv, r.get_component_filter(), 100 );
+        CHECK( g->u.is_recipe_available( r ) == expected );
+        CHECK( r.requirements().get_availability() == flags );
+        available += expected ? 1 : 0;
+        if( !expected ) {
+            unavailable = &r;
+        }
+    }
+    CHECK( available > 0 );
+
+    // Traits can change what is available.
+    REQUIRE( unavailable != nullptr );
+    const trait_id debug_hs( "DEBUG_HS" );
+    g->u.toggle_trait( debug_hs );
+    CHECK( g->u.is_recipe_available( *unavailable ) );
+    g->u.toggle_trait( debug_hs );
+    CHECK_FALSE( g->u.is_recipe_available( *unavailable ) );
+}
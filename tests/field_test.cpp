@@ -0,0 +1,70 @@
+#include <set>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "field.h"
+
+static std::set<field_id> field_types( const field &fld )
+{
+    std::set<field_id> result;
+    for( const auto &entry : fld ) {
+        CHECK( entry.first == entry.second.get_field_type() );
+        result.insert( entry.first );
+    }
+    return result;
+}
+
+TEST_CASE( "field_entries_stay_in_place", "[field]" )
+{
+    field fld;
+    CHECK( fld.field_count() == 0 );
+    CHECK( fld.begin() == fld.end() );
+
+    REQUIRE( fld.add_field( fd_blood, 1 ) );
+    field_entry *const blood = fld.find_field( fd_blood );
+    REQUIRE( blood != nullptr );
+    CHECK_FALSE( fld.add_field( fd_blood, 1 ) );
+    CHECK( blood->get_field_intensity() == 2 );
+    CHECK_FALSE( fld.add_field( fd_null ) );
+
+    // More fields than are stored inline.
+    REQUIRE( fld.add_field( fd_fire, 1 ) );
+    REQUIRE( fld.add_field( fd_smoke, 2 ) );
+    REQUIRE( fld.add_field( fd_web, 3 ) );
+    field_entry *const smoke = fld.find_field( fd_smoke );
+    CHECK( fld.field_count() == 4 );
+    CHECK( fld.find_field( fd_blood ) == blood );
+    CHECK( field_types( fld ) == std::set<field_id>( { fd_blood, fd_fire, fd_smoke, fd_web } ) );
+
+    CHECK( fld.remove_field( fd_fire ) );
+    CHECK_FALSE( fld.remove_field( fd_fire ) );
+    CHECK( fld.find_field( fd_fire ) == nullptr );
+    CHECK( fld.field_count() == 3 );
+    REQUIRE( fld.add_field( fd_acid, 1 ) );
+    CHECK( fld.find_field( fd_smoke ) == smoke );
+    CHECK( fld.find_field( fd_blood ) == blood );
+
+    const field copy = fld;
+    CHECK( field_types( copy ) == std::set<field_id>( { fd_blood, fd_acid, fd_smoke, fd_web } ) );
+    CHECK( copy.find_field( fd_web )->get_field_intensity() == 3 );
+
+    // Adding and removing entries while iterating, as field processing does. Entries are
+    // visited in the order of their types, so only added entries of later types are visited.
+    std::vector<field_id> visited;
+    for( auto it = fld.begin(); it != fld.end(); ) {
+        visited.push_back( it->first );
+        if( it->first == fd_blood ) {
+            fld.add_field( fd_sap, 1 );
+        } else if( it->first == fd_smoke ) {
+            fld.add_field( fd_bile, 1 );
+        }
+        fld.remove_field( it++ );
+    }
+    CHECK( visited == std::vector<field_id>( { fd_blood, fd_web, fd_acid, fd_sap, fd_smoke } ) );
+    CHECK( fld.field_count() == 1 );
+    CHECK( fld.remove_field( fd_bile ) );
+    CHECK( fld.field_count() == 0 );
+    CHECK( fld.begin() == fld.end() );
+    CHECK( fld.displayed_field_type() == fd_null );
+    CHECK( copy.field_count() == 4 );
+}
@@ -0,0 +1,90 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "json.h"
+
+// Reads all members of the objects in the array, as data loading does.
+static std::string read_all( JsonIn &jsin )
+{
+    std::ostringstream out;
+    JsonArray ja = jsin.get_array();
+    while( ja.has_more() ) {
+        JsonObject jo = ja.next_object();
+        for( const std::string &name : jo.get_member_names() ) {
+            out << name << "=";
+            JsonIn &member = *jo.get_raw( name );
+            if( member.test_string() ) {
+                out << member.get_string();
+            } else if( member.test_number() ) {
+                out << member.get_float();
+            } else {
+                member.skip_value();
+            }
+            out << ";";
+        }
+        out << jo.str() << "|";
+    }
+    return out.str();
+}
+
+static std::string read_stream( const std::string &text )
+{
+    std::istringstream iss( text );
+    JsonIn jsin( iss );
+    try {
+        return read_all( jsin );
+    } catch( const JsonError &err ) {
+        return err.what();
+    }
+}
+
+static std::string read_buffer( const std::string &text )
+{
+    JsonBuffer buffer( text.data(), text.size() );
+    JsonIn jsin( buffer );
+    try {
+        return read_all( jsin );
+    } catch( const JsonError &err ) {
+        return err.what();
+    }
+}
+
+TEST_CASE( "json_buffer_reads_like_a_stream", "[json]" )
+{
+    const std::vector<std::string> texts = {
+        "[]",
+        "[ { \"id\": \"a\", \"weight\": 1.5, \"flags\": [ \"X\", [ {}, [] ] ] } ]\n",
+        "[{\"id\":\"esc\\\"aped\\u0041\",\"nested\":{\"a\":{\"b\":[1,2,{\"c\":null}]}},"
+        "\"t\":true}]",
+        "[ { \"id\": \"b\", \"x\": -1e3 }, { \"id\": \"c\", \"list\": [ false, \"]}\" ] } ]",
+        // invalid text is reported the same way
+        "[ { \"id\": \"a\", \"list\": [ 1, 2, ] } ]",
+        "[ { \"id\": \"a\", \"list\": [ 1 2 ] } ]",
+        "[ { \"id\": \"a\" \"b\": 1 } ]",
+        "[ { \"id\": \"a\", \"obj\": { \"x\": 1 ] } ]",
+        "[ { \"id\": \"a\", \"obj\": { \"x\": 1 } ]",
+        "[ { \"id\": \"a\", \"s\": \"line\nbreak\" } ]",
+        "[ { \"id\": \"a\", \"obj\": { \"x\": tru } } ]",
+        "[ { \"id\": \"a\", \"id\": \"b\" } ]",
+    };
+    for( const std::string &text : texts ) {
+        CAPTURE( text );
+        CHECK( read_buffer( text ) == read_stream( text ) );
+    }
+}
+
+TEST_CASE( "json_buffer_indexes_containers", "[json]" )
+{
+    const std::string text = " [ { \"a\": [ 1, \"]\" ] }, {} ] ";
+    JsonBuffer buffer( text.data(), text.size() );
+    CHECK( buffer.end_of_container( 1 ) == static_cast<int>( text.size() ) - 1 );
+    CHECK( buffer.end_of_container( 3 ) == 22 );
+    CHECK( buffer.end_of_container( 10 ) == 20 );
+    CHECK( buffer.end_of_container( 0 ) == -1 );
+
+    const std::string invalid = "[ [ 1, ] ]";
+    JsonBuffer invalid_buffer( invalid.data(), invalid.size() );
+    CHECK( invalid_buffer.end_of_container( 0 ) == -1 );
+}
@@ -1,4 +1,9 @@
+#include <chrono>
+#include <cstdio>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "avatar.h"
 #include "catch/catch.hpp"
@@ -7,8 +12,12 @@
 #include "map_helpers.h"
 #include "player.h"
 #include "enums.h"
+#include "field.h"
 #include "game_constants.h"
 #include "type_id.h"
+#include "vehicle.h"
+#include "vpart_position.h"
+#include "vpart_range.h"
 
 TEST_CASE( "destroy_grabbed_furniture" )
 {
@@ -78,3 +87,221 @@ TEST_CASE( "tinymap_bounds_checking" )
         }
     }
 }
+
+static void check_vehicle_parts_cached( const vehicle &veh )
+{
+    for( const vpart_reference &vp : veh.get_all_parts() ) {
+        const tripoint p = veh.global_part_pos3( vp.part() );
+        INFO( "( " << p.x << ", " << p.y << ", " << p.z << " )" );
+        const optional_vpart_position ovp = g->m.veh_at( p );
+        REQUIRE( ovp );
+        CHECK( &ovp->vehicle() == &veh );
+    }
+}
+
+TEST_CASE( "vehicle_part_cache_follows_vehicles" )
+{
+    clear_map();
+    vehicle *first = g->m.add_vehicle( vproto_id( "bicycle" ), tripoint( 60, 60, 0 ), 0, 0, 0 );
+    vehicle *second = g->m.add_vehicle( vproto_id( "bicycle" ), tripoint( 70, 60, 0 ), 0, 0, 0 );
+    REQUIRE( first != nullptr );
+    REQUIRE( second != nullptr );
+    check_vehicle_parts_cached( *first );
+    check_vehicle_parts_cached( *second );
+
+    // Re-caching the first vehicle moves parts of the second one around in the cache
+    g->m.update_vehicle_cache( first, 0 );
+    check_vehicle_parts_cached( *first );
+    check_vehicle_parts_cached( *second );
+
+    std::vector<tripoint> first_tiles;
+    for( const vpart_reference &vp : first->get_all_parts() ) {
+        first_tiles.push_back( first->global_part_pos3( vp.part() ) );
+    }
+    g->m.destroy_vehicle( first );
+    for( const tripoint &p : first_tiles ) {
+        CHECK( !g->m.veh_at( p ) );
+    }
+    check_vehicle_parts_cached( *second );
+}
+
+// The vehicle part cache as it was before it was packed: a flag per tile and a map from
+// positions to parts, where the first part added at a position wins.
+struct reference_vehicle_cache {
+    bool exists_at[MAPSIZE_X][MAPSIZE_Y] = {};
+    std::map<tripoint, std::pair<const vehicle *, int>> parts;
+
+    void add( const vehicle &veh ) {
+        for( const vpart_reference &vp : veh.get_all_parts() ) {
+            const tripoint p = veh.global_part_pos3( vp.part() );
+            parts.emplace( p, std::make_pair( &veh, static_cast<int>( vp.part_index() ) ) );
+            exists_at[p.x][p.y] = true;
+        }
+    }
+
+    const std::pair<const vehicle *, int> *find( const tripoint &p ) const {
+        if( !exists_at[p.x][p.y] ) {
+            return nullptr;
+        }
+        const auto iter = parts.find( p );
+        return iter != parts.end() ? &iter->second : nullptr;
+    }
+};
+
+// The outside and visibility caches as they were before level_cache packed them.
+struct reference_light_cache {
+    bool outside_cache[MAPSIZE_X][MAPSIZE_Y] = {};
+    int visibility_cache[MAPSIZE_X][MAPSIZE_Y] = {};
+
+    explicit reference_light_cache( const level_cache &ch ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                outside_cache[x][y] = ch.outside_cache[level_cache::tile_offset( x, y )];
+                visibility_cache[x][y] = ch.visibility_cache[x][y];
+            }
+        }
+    }
+};
+
+TEST_CASE( "steady_fire_keeps_transparency_cache" )
+{
+    clear_map();
+    const tripoint fire_pos( 60, 60, 0 );
+    // A fire in a stove doesn't smoke or spread, and fire is transparent at every intensity.
+    g->m.furn_set( fire_pos, furn_id( "f_woodstove" ) );
+    g->m.add_field( fire_pos, fd_fire, 1, -10_minutes );
+    const auto &dirty = g->m.get_cache_ref( fire_pos.z ).transparency_cache_dirty;
+    g->m.build_map_cache( fire_pos.z, true );
+    REQUIRE( dirty.none() );
+
+    for( int turn = 0; turn < 5; turn++ ) {
+        g->m.process_fields();
+        CHECK( dirty.none() );
+    }
+
+    // Opaque smoke over the fire, old enough to thin out when it is processed.
+    g->m.add_field( fire_pos, fd_smoke, 3, 1000_hours );
+    g->m.build_map_cache( fire_pos.z, true );
+    REQUIRE( dirty.none() );
+    g->m.process_fields();
+    const field_entry *smoke = g->m.get_field( fire_pos, fd_smoke );
+    CHECK( ( smoke == nullptr || smoke->get_field_intensity() < 3 ) );
+    CHECK( dirty.test( fire_pos.x / SEEX + ( fire_pos.y / SEEY ) * MAPSIZE ) );
+}
+
+TEST_CASE( "level_cache_performance", "[.]" )
+{
+    clear_map();
+    const int iterations = 100;
+    std::unique_ptr<reference_vehicle_cache> reference( new reference_vehicle_cache() );
+    for( int x = 20; x < 110; x += 10 ) {
+        for( int y = 20; y < 110; y += 10 ) {
+            vehicle *veh = g->m.add_vehicle( vproto_id( "bicycle" ), tripoint( x, y, 0 ), 0, 0, 0 );
+            REQUIRE( veh != nullptr );
+            reference->add( *veh );
+        }
+    }
+
+    const auto start_caches = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        // Forces the outside, transparency, floor, seen caches and the lightmap to be rebuilt
+        g->m.invalidate_map_cache( 0 );
+        g->m.build_map_cache( 0 );
+    }
+    const auto end_caches = std::chrono::high_resolution_clock::now();
+
+    const level_cache &ch = g->m.get_cache_ref( 0 );
+    std::unique_ptr<reference_light_cache> reference_light( new reference_light_cache( ch ) );
+    int lit_found = 0;
+    const auto start_lit = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( ch.outside_cache[level_cache::tile_offset( x, y )] &&
+                    ch.visibility_cache[x][y] != LL_DARK ) {
+                    lit_found++;
+                }
+            }
+        }
+    }
+    const auto end_lit = std::chrono::high_resolution_clock::now();
+
+    int reference_lit_found = 0;
+    const auto start_reference_lit = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( reference_light->outside_cache[x][y] &&
+                    reference_light->visibility_cache[x][y] != LL_DARK ) {
+                    reference_lit_found++;
+                }
+            }
+        }
+    }
+    const auto end_reference_lit = std::chrono::high_resolution_clock::now();
+    CHECK( lit_found == reference_lit_found );
+
+    // Both caches have to agree on every tile before their timings mean anything.
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const tripoint p( x, y, 0 );
+            const optional_vpart_position vp = g->m.veh_at( p );
+            const std::pair<const vehicle *, int> *expected = reference->find( p );
+            INFO( "( " << x << ", " << y << " )" );
+            REQUIRE( static_cast<bool>( vp ) == ( expected != nullptr ) );
+            if( vp ) {
+                CHECK( &vp->vehicle() == expected->first );
+                CHECK( static_cast<int>( vp->part_index() ) == expected->second );
+            }
+        }
+    }
+
+    int parts_found = 0;
+    const auto start_veh_at = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( g->m.veh_at( tripoint( x, y, 0 ) ) ) {
+                    parts_found++;
+                }
+            }
+        }
+    }
+    const auto end_veh_at = std::chrono::high_resolution_clock::now();
+
+    int reference_parts_found = 0;
+    const auto start_reference = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( reference->find( tripoint( x, y, 0 ) ) ) {
+                    reference_parts_found++;
+                }
+            }
+        }
+    }
+    const auto end_reference = std::chrono::high_resolution_clock::now();
+    CHECK( parts_found == iterations * static_cast<int>( reference->parts.size() ) );
+    CHECK( parts_found == reference_parts_found );
+
+    const long long diff_caches = std::chrono::duration_cast<std::chrono::microseconds>
+                                  ( end_caches - start_caches ).count();
+    const long long diff_lit = std::chrono::duration_cast<std::chrono::microseconds>
+                               ( end_lit - start_lit ).count();
+    const long long diff_reference_lit = std::chrono::duration_cast<std::chrono::microseconds>
+                                         ( end_reference_lit - start_reference_lit ).count();
+    const long long diff_veh_at = std::chrono::duration_cast<std::chrono::microseconds>
+                                  ( end_veh_at - start_veh_at ).count();
+    const long long diff_reference = std::chrono::duration_cast<std::chrono::microseconds>
+                                     ( end_reference - start_reference ).count();
+    printf( "build_map_cache() executed %d times in %lld microseconds.\n",
+            iterations, diff_caches );
+    printf( "outside and visibility caches read on every tile %d times in %lld microseconds.\n",
+            iterations, diff_lit );
+    printf( "the old outside and visibility caches read on every tile %d times "
+            "in %lld microseconds.\n", iterations, diff_reference_lit );
+    printf( "veh_at() on every tile executed %d times in %lld microseconds.\n",
+            iterations, diff_veh_at );
+    printf( "the old vehicle part cache on every tile executed %d times in %lld microseconds.\n",
+            iterations, diff_reference );
+}
@@ -10,6 +10,7 @@
 
 #include "avatar.h"
 #include "catch/catch.hpp"
+#include "creature_tracker.h"
 #include "game.h"
 #include "map.h"
 #include "map_helpers.h"
@@ -336,3 +337,46 @@ TEST_CASE( "monster_speed_trig", "[speed]" )
     trigdist = true;
     monster_check();
 }
+
+TEST_CASE( "creature_tracker_radius_queries", "[monster]" )
+{
+    clear_map();
+    trigdist = false;
+    const tripoint center( 60, 60, 0 );
+    monster &near = spawn_test_monster( "mon_zombie", center + tripoint( 2, 0, 0 ) );
+    monster &mid = spawn_test_monster( "mon_zombie", center + tripoint( -5, 13, 0 ) );
+    monster &far = spawn_test_monster( "mon_zombie", center + tripoint( 30, -30, 0 ) );
+    Creature_tracker &tracker = *g->critter_tracker;
+
+    CHECK( tracker.find_all_in_radius( center, 1 ).empty() );
+    CHECK( tracker.find_all_in_radius( center, 13 ) == std::vector<monster *> { &near, &mid } );
+    CHECK( tracker.find_all_in_radius( center, 30 ) == std::vector<monster *> { &near, &mid, &far } );
+
+    const auto any = []( const monster & ) {
+        return true;
+    };
+    CHECK( tracker.find_nearest( center, 60, any ) == &near );
+    CHECK( tracker.find_nearest( center, 60, [&]( const monster & m ) {
+        return &m != &near;
+    } ) == &mid );
+    CHECK( tracker.find_nearest( center, 10, [&]( const monster & m ) {
+        return &m != &near;
+    } ) == nullptr );
+    // Friendly monsters are skipped by a hostility check, even when they are closer.
+    near.friendly = -1;
+    CHECK( tracker.find_nearest( center, 60, []( const monster & m ) {
+        return m.attitude_to( g->u ) == Creature::A_HOSTILE;
+    } ) == &mid );
+    near.friendly = 0;
+
+    // Moving across submap borders keeps the index up to date.
+    far.setpos( center + tripoint( 1, 1, 0 ) );
+    CHECK( tracker.find_all_in_radius( center, 60 ).front() == &far );
+    CHECK( tracker.find_nearest( center, 60, any ) == &far );
+    CHECK( tracker.find_all_in_radius( center, 20 ).size() == 3 );
+
+    near.die( nullptr );
+    tracker.remove_dead();
+    CHECK( tracker.find_all_in_radius( center, 60 ) == std::vector<monster *> { &far, &mid } );
+    clear_creatures();
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <vector>
+
+#include "calendar.h"
+#include "catch/catch.hpp"
+#include "game.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+#include "type_id.h"
+
+static void check_route( const std::vector<tripoint> &path, const tripoint &from,
+                         const tripoint &to )
+{
+    REQUIRE( !path.empty() );
+    CHECK( path.back() == to );
+    tripoint prev = from;
+    for( const tripoint &p : path ) {
+        INFO( "( " << p.x << ", " << p.y << ", " << p.z << " )" );
+        CHECK( square_dist( prev, p ) == 1 );
+        CHECK( g->m.passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "long_route_goes_through_a_gap_in_a_wall", "[pathfinding]" )
+{
+    clear_map();
+    const ter_id t_wall_id( "t_concrete_wall" );
+    // A wall across the whole map with a single gap far away from the straight line
+    const int wall_x = 66;
+    const tripoint gap( wall_x, 110, 0 );
+    for( int y = 0; y < MAPSIZE_Y; y++ ) {
+        if( y != gap.y ) {
+            g->m.ter_set( tripoint( wall_x, y, 0 ), t_wall_id );
+        }
+    }
+
+    const pathfinding_settings settings( 0, 200, 1000, 0, false, false, false, false );
+    const tripoint from( 30, 30, 0 );
+    const tripoint to( 100, 30, 0 );
+
+    const std::vector<tripoint> path = g->m.route( from, to, settings );
+    check_route( path, from, to );
+    CHECK( std::find( path.begin(), path.end(), gap ) != path.end() );
+
+    WHEN( "the gap is closed and another one opens" ) {
+        const tripoint new_gap( wall_x, 20, 0 );
+        g->m.ter_set( gap, t_wall_id );
+        g->m.ter_set( new_gap, ter_id( "t_grass" ) );
+        THEN( "the route uses the new gap" ) {
+            const std::vector<tripoint> new_path = g->m.route( from, to, settings );
+            check_route( new_path, from, to );
+            CHECK( std::find( new_path.begin(), new_path.end(), new_gap ) != new_path.end() );
+        }
+    }
+
+    WHEN( "the wall is closed completely" ) {
+        g->m.ter_set( gap, t_wall_id );
+        THEN( "there is no route" ) {
+            CHECK( g->m.route( from, to, settings ).empty() );
+        }
+    }
+}
+
+TEST_CASE( "flow_field_is_shared_by_routes_to_the_same_target", "[pathfinding]" )
+{
+    clear_map();
+    const ter_id t_wall_id( "t_concrete_wall" );
+    const int wall_x = 66;
+    const tripoint gap( wall_x, 90, 0 );
+    for( int y = 0; y < MAPSIZE_Y; y++ ) {
+        if( y != gap.y ) {
+            g->m.ter_set( tripoint( wall_x, y, 0 ), t_wall_id );
+        }
+    }
+
+    const pathfinding_settings settings( 0, 200, 1000, 0, false, false, false, false );
+    const tripoint target( 100, 60, 0 );
+    const tripoint first( 30, 30, 0 );
+    const tripoint second( 40, 100, 0 );
+
+    std::vector<tripoint> path;
+    // Requests are counted per turn
+    calendar::turn.increment();
+    // A single request is left to map::route
+    REQUIRE( !g->m.route_from_flow_field( first, target, settings, path ) );
+    REQUIRE( g->m.route_from_flow_field( second, target, settings, path ) );
+    check_route( path, second, target );
+    CHECK( std::find( path.begin(), path.end(), gap ) != path.end() );
+
+    REQUIRE( g->m.route_from_flow_field( first, target, settings, path ) );
+    check_route( path, first, target );
+    CHECK( std::find( path.begin(), path.end(), gap ) != path.end() );
+
+    // The field is rebuilt when the map changes, without a route it is left to map::route
+    g->m.ter_set( gap, t_wall_id );
+    CHECK( !g->m.route_from_flow_field( first, target, settings, path ) );
+    CHECK( path.empty() );
+}
@@ -0,0 +1,98 @@
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <string>
+
+#include "catch/catch.hpp"
+#include "filesystem.h"
+#include "save_writer.h"
+
+static std::string read_file( const std::string &path )
+{
+    std::ifstream fin( path, std::ifstream::binary );
+    return std::string( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+}
+
+static void save_files( const std::string &first, const std::string &second )
+{
+    save_writer &writer = get_save_writer();
+    writer.begin_save();
+    write_save_file( "tests/data/save_writer_test_1.json", [&]( std::ostream & fout ) {
+        fout << first;
+    }, false );
+    write_save_file( "tests/data/save_writer_test_2.json", [&]( std::ostream & fout ) {
+        fout << second;
+    }, true );
+    writer.end_save();
+    writer.wait();
+}
+
+TEST_CASE( "save_writer_writes_in_background", "[save_writer]" )
+{
+    if( !save_writer::available() ) {
+        return;
+    }
+    save_writer &writer = get_save_writer();
+    save_writer::save_stats stats;
+    // Drop the outcome of earlier saves.
+    writer.take_finished( stats );
+
+    save_files( "[1]", "[2]" );
+    REQUIRE( writer.take_finished( stats ) );
+    CHECK( stats.files_written == 2 );
+    CHECK( stats.bytes_written == 6 );
+    CHECK( stats.errors.empty() );
+    CHECK( writer.progress().done == 2 );
+    CHECK( writer.progress().total == 2 );
+    CHECK( read_file( "tests/data/save_writer_test_1.json" ) == "[1]" );
+    CHECK( read_file( "tests/data/save_writer_test_2.json" ) == "[2]" );
+    CHECK_FALSE( file_exist( "tests/data/save_writer_test_1.json.temp" ) );
+    CHECK_FALSE( writer.take_finished( stats ) );
+
+    // Only changed files are written again.
+    save_files( "[1]", "[3]" );
+    REQUIRE( writer.take_finished( stats ) );
+    CHECK( stats.files_written == 1 );
+    CHECK( stats.files_unchanged == 1 );
+    CHECK( read_file( "tests/data/save_writer_test_2.json" ) == "[3]" );
+
+    // Unless something else changed the file in between.
+    write_save_file( "tests/data/save_writer_test_1.json", []( std::ostream & fout ) {
+        fout << "[4]";
+    }, false );
+    save_files( "[1]", "[3]" );
+    REQUIRE( writer.take_finished( stats ) );
+    CHECK( stats.files_written == 1 );
+    CHECK( read_file( "tests/data/save_writer_test_1.json" ) == "[1]" );
+
+    writer.begin_save();
+    remove_save_file( "tests/data/save_writer_test_1.json" );
+    remove_save_file( "tests/data/save_writer_test_2.json" );
+    CHECK( file_exist( "tests/data/save_writer_test_1.json" ) );
+    writer.end_save();
+    writer.wait();
+    REQUIRE( writer.take_finished( stats ) );
+    CHECK( stats.files_removed == 2 );
+    CHECK_FALSE( file_exist( "tests/data/save_writer_test_1.json" ) );
+    CHECK_FALSE( file_exist( "tests/data/save_writer_test_2.json" ) );
+}
+
+TEST_CASE( "save_writer_reports_failed_writes", "[save_writer]" )
+{
+    if( !save_writer::available() ) {
+        return;
+    }
+    save_writer &writer = get_save_writer();
+    save_writer::save_stats stats;
+    writer.take_finished( stats );
+
+    writer.begin_save();
+    write_save_file( "tests/data/save_writer_missing_dir/file.json", []( std::ostream & fout ) {
+        fout << "{}";
+    }, false );
+    writer.end_save();
+    writer.wait();
+    REQUIRE( writer.take_finished( stats ) );
+    CHECK( stats.files_written == 0 );
+    CHECK( stats.errors.size() == 1 );
+}
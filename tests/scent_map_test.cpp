@@ -0,0 +1,185 @@
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+#include "catch/catch.hpp"
+#include "game.h"
+#include "game_constants.h"
+#include "point.h"
+#include "scent_map.h"
+
+using scent_array_int = scent_map::scent_array<int>;
+using scent_array_bool = scent_map::scent_array<bool>;
+
+static const point center( MAPSIZE_X / 2, MAPSIZE_Y / 2 );
+static const rectangle radius_area( center - point( SCENT_RADIUS, SCENT_RADIUS ),
+                                    center + point( SCENT_RADIUS, SCENT_RADIUS ) );
+
+class test_scent_map : public scent_map
+{
+    public:
+        test_scent_map() : scent_map( *g ) {
+            reset();
+        }
+
+        const scent_array_int &values() const {
+            return grscent;
+        }
+
+        void place( const point &p, const int value ) {
+            grscent[p.x][p.y] = value;
+            scent_bounds = nonzero_bounds( rectangle( point_zero,
+                                           point( MAPSIZE_X - 1, MAPSIZE_Y - 1 ) ) );
+        }
+};
+
+// The diffusion as it was done before the area was limited and the kernel vectorized.
+static void reference_diffuse( scent_array_int &grscent, const scent_array_bool &blocks_scent,
+                               const scent_array_bool &reduces_scent )
+{
+    std::unique_ptr<scent_array_int> sum_3_scent_y( new scent_array_int() );
+    std::unique_ptr<scent_array_int> squares_used_y( new scent_array_int() );
+    const int diffusivity = 100;
+    const rectangle &r = radius_area;
+    for( int x = r.p_min.x - 1; x <= r.p_max.x + 1; ++x ) {
+        for( int y = r.p_min.y; y <= r.p_max.y; ++y ) {
+            ( *sum_3_scent_y )[y][x] = 0;
+            ( *squares_used_y )[y][x] = 0;
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks_scent[x][i] ) {
+                    const int used = reduces_scent[x][i] ? 2 : 10;
+                    ( *sum_3_scent_y )[y][x] += used * grscent[x][i];
+                    ( *squares_used_y )[y][x] += used;
+                }
+            }
+        }
+    }
+    for( int x = r.p_min.x; x <= r.p_max.x; ++x ) {
+        for( int y = r.p_min.y; y <= r.p_max.y; ++y ) {
+            int &scent_here = grscent[x][y];
+            if( blocks_scent[x][y] ) {
+                scent_here = 0;
+                continue;
+            }
+            const int squares_used = ( *squares_used_y )[y][x - 1] + ( *squares_used_y )[y][x] +
+                                     ( *squares_used_y )[y][x + 1];
+            const int this_diffusivity = reduces_scent[x][y] ? diffusivity / 5 : diffusivity;
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            scent_here = ( temp_scent + this_diffusivity * ( ( *sum_3_scent_y )[y][x - 1] +
+                           ( *sum_3_scent_y )[y][x] + ( *sum_3_scent_y )[y][x + 1] ) ) / ( 1000 * 10 );
+        }
+    }
+}
+
+struct scent_flags {
+    scent_array_bool blocks;
+    scent_array_bool reduces;
+};
+
+// Walls and REDUCE_SCENT cells scattered over the map, some cells have both flags like
+// vehicle parts on walls do.
+static std::unique_ptr<scent_flags> scattered_flags()
+{
+    std::unique_ptr<scent_flags> flags( new scent_flags() );
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            flags->blocks[x][y] = ( x * 3 + y * 5 ) % 11 == 0;
+            flags->reduces[x][y] = ( x + y * 2 ) % 7 == 0;
+        }
+    }
+    return flags;
+}
+
+static void fill_scent( test_scent_map &scent, scent_array_int &reference )
+{
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            const int value = ( x * 7 + y * 13 ) % 500;
+            scent.place( point( x, y ), value );
+            reference[x][y] = value;
+        }
+    }
+}
+
+TEST_CASE( "scent_diffusion_matches_reference", "[scent]" )
+{
+    const std::unique_ptr<scent_flags> flags = scattered_flags();
+    std::unique_ptr<test_scent_map> scent( new test_scent_map() );
+    std::unique_ptr<scent_array_int> reference( new scent_array_int() );
+    fill_scent( *scent, *reference );
+
+    for( int turn = 0; turn < 5; ++turn ) {
+        scent->diffuse( radius_area, flags->blocks, flags->reduces );
+        reference_diffuse( *reference, flags->blocks, flags->reduces );
+        CHECK( scent->values() == *reference );
+    }
+}
+
+TEST_CASE( "scent_diffusion_only_covers_cells_with_scent", "[scent]" )
+{
+    const std::unique_ptr<scent_flags> flags = scattered_flags();
+    std::unique_ptr<test_scent_map> scent( new test_scent_map() );
+    std::unique_ptr<scent_array_int> reference( new scent_array_int() );
+    CHECK( scent->diffusion_area( tripoint( center, 0 ) ).p_min.x >
+           scent->diffusion_area( tripoint( center, 0 ) ).p_max.x );
+
+    const point source = center + point( 3, 1 );
+    for( int turn = 0; turn < 30; ++turn ) {
+        scent->place( source, 500 );
+        ( *reference )[source.x][source.y] = 500;
+        const rectangle area = scent->diffusion_area( tripoint( center, 0 ) );
+        CHECK( area.p_min.x >= source.x - turn - 1 );
+        CHECK( area.p_max.y <= source.y + turn + 1 );
+        scent->diffuse( area, flags->blocks, flags->reduces );
+        reference_diffuse( *reference, flags->blocks, flags->reduces );
+        CHECK( scent->values() == *reference );
+    }
+}
+
+static long long time_diffusion( const rectangle &area, const int iterations,
+                                 const std::function<void( const rectangle & )> &diffuse )
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; ++i ) {
+        diffuse( area );
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+}
+
+TEST_CASE( "scent_diffusion_performance", "[.]" )
+{
+    const int iterations = 10000;
+    const std::unique_ptr<scent_flags> flags = scattered_flags();
+    std::unique_ptr<test_scent_map> scent( new test_scent_map() );
+    std::unique_ptr<scent_array_int> reference( new scent_array_int() );
+    fill_scent( *scent, *reference );
+
+    const long long reference_time = time_diffusion( radius_area, iterations,
+    [&]( const rectangle & ) {
+        reference_diffuse( *reference, flags->blocks, flags->reduces );
+    } );
+    const auto diffuse = [&]( const rectangle & area ) {
+        scent->diffuse( area, flags->blocks, flags->reduces );
+    };
+    const long long full_time = time_diffusion( radius_area, iterations, diffuse );
+
+    // Scent around a single cell, as left by a player who just arrived.
+    scent->reset();
+    const point source = center + point( 3, 1 );
+    scent->place( source, 500 );
+    for( int turn = 0; turn < 10; ++turn ) {
+        diffuse( scent->diffusion_area( tripoint( center, 0 ) ) );
+    }
+    const long long local_time = time_diffusion( scent->diffusion_area( tripoint( center, 0 ) ),
+                                 iterations, diffuse );
+
+    printf( "reference diffusion executed %d times in %lld microseconds.\n",
+            iterations, reference_time );
+    printf( "diffuse() over the full area executed %d times in %lld microseconds.\n",
+            iterations, full_time );
+    printf( "diffuse() around a single source executed %d times in %lld microseconds.\n",
+            iterations, local_time );
+}
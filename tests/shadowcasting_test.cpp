@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <random>
@@ -340,6 +341,58 @@ static void shadowcasting_float_quad(
     REQUIRE( passed );
 }
 
+static void shadowcasting_sight_tables_vs_generic(
+    const int iterations, const unsigned int denominator = DENOMINATOR,
+    const point &origin = point( 65, 65 ) )
+{
+    static float lit_tables[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static float lit_generic[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static float transparency_cache[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    randomly_fill_transparency( transparency_cache, NUMERATOR, denominator );
+    std::fill_n( &lit_tables[0][0], MAPSIZE * SEEX * MAPSIZE * SEEY, LIGHT_TRANSPARENCY_SOLID );
+    std::fill_n( &lit_generic[0][0], MAPSIZE * SEEX * MAPSIZE * SEEY, LIGHT_TRANSPARENCY_SOLID );
+
+    const bool had_tables = shadowcasting_sight_tables;
+    const int offsetX = origin.x;
+    const int offsetY = origin.y;
+
+    const auto time_cast = [&]( float ( &lit )[MAPSIZE * SEEX][MAPSIZE * SEEY] ) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for( int i = 0; i < iterations; i++ ) {
+            castLightAll<float, float, sight_calc, sight_check, update_light,
+                         accumulate_transparency>( lit, transparency_cache, offsetX, offsetY );
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    };
+    shadowcasting_sight_tables = false;
+    const long long diff_generic = time_cast( lit_generic );
+    shadowcasting_sight_tables = true;
+    const long long diff_tables = time_cast( lit_tables );
+    shadowcasting_sight_tables = had_tables;
+
+    if( iterations > 1 ) {
+        printf( "Generic castLight (denominator %u) "
+                "executed %d times in %lld microseconds.\n",
+                denominator, iterations, diff_generic );
+        printf( "Table-driven castLight (denominator %u) "
+                "executed %d times in %lld microseconds.\n",
+                denominator, iterations, diff_tables );
+    }
+
+    // The table-driven kernel uses the same expressions, so the values have to be identical.
+    const bool passed = std::equal( &lit_generic[0][0],
+                                    &lit_generic[0][0] + MAPSIZE * SEEX * MAPSIZE * SEEY,
+                                    &lit_tables[0][0] );
+
+    if( !passed ) {
+        print_grid_comparison( offsetX, offsetY, transparency_cache, lit_generic, lit_tables );
+    }
+
+    INFO( "origin ( " << offsetX << ", " << offsetY << " )" );
+    REQUIRE( passed );
+}
+
 static void shadowcasting_3d_2d( const int iterations )
 {
     float seen_squares_control[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{0}};
@@ -637,6 +690,80 @@ TEST_CASE( "shadowcasting_float_quad_performance", "[.]" )
     shadowcasting_float_quad( 1000000, 100 );
 }
 
+TEST_CASE( "shadowcasting_sight_tables_equivalence", "[shadowcasting]" )
+{
+    // Off-centre origins and origins near the edges, where rows are clipped to the map.
+    const int max_x = MAPSIZE * SEEX - 1;
+    const int max_y = MAPSIZE * SEEY - 1;
+    for( const point &origin : {
+             point( 65, 65 ), point( 20, 90 ), point( 3, 70 ), point( 0, 0 ),
+             point( max_x, 1 ), point( max_x - 2, max_y ), point( 70, max_y - 1 )
+         } ) {
+        shadowcasting_sight_tables_vs_generic( 1, DENOMINATOR, origin );
+        shadowcasting_sight_tables_vs_generic( 1, 4, origin );
+    }
+}
+
+TEST_CASE( "shadowcasting_sight_tables_performance", "[.]" )
+{
+    shadowcasting_sight_tables_vs_generic( 100000 );
+    shadowcasting_sight_tables_vs_generic( 100000, 4 );
+}
+
+TEST_CASE( "shadowcasting_parallel_equivalence", "[shadowcasting]" )
+{
+    static float transparency_cache[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static bool floor_cache[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static four_quadrants lit_sequential[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static four_quadrants lit_parallel[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static float seen_sequential[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    static float seen_parallel[MAPSIZE * SEEX][MAPSIZE * SEEY];
+    randomly_fill_transparency( transparency_cache, 1, 4 );
+    const bool was_parallel = parallel_shadowcasting;
+    const tripoint origin( 65, 65, 0 );
+
+    const auto cast_2d = [&]( four_quadrants( &lit )[MAPSIZE * SEEX][MAPSIZE * SEEY],
+    float ( &seen )[MAPSIZE * SEEX][MAPSIZE * SEEY] ) {
+        std::fill_n( &lit[0][0], MAPSIZE * SEEX * MAPSIZE * SEEY, four_quadrants( 0.0f ) );
+        std::fill_n( &seen[0][0], MAPSIZE * SEEX * MAPSIZE * SEEY, LIGHT_TRANSPARENCY_SOLID );
+        castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                     accumulate_transparency>( lit, transparency_cache, origin.x, origin.y, 0, 100.0f );
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            seen, transparency_cache, origin.x, origin.y );
+    };
+    parallel_shadowcasting = false;
+    cast_2d( lit_sequential, seen_sequential );
+    parallel_shadowcasting = true;
+    cast_2d( lit_parallel, seen_parallel );
+    CHECK( std::equal( &lit_sequential[0][0].values[0],
+                       &lit_sequential[MAPSIZE * SEEX - 1][MAPSIZE * SEEY - 1].values[3] + 1,
+                       &lit_parallel[0][0].values[0] ) );
+    CHECK( std::equal( &seen_sequential[0][0], &seen_sequential[0][0] + MAPSIZE * SEEX * MAPSIZE * SEEY,
+                       &seen_parallel[0][0] ) );
+
+    const auto cast_3d = [&]( float ( &seen )[MAPSIZE * SEEX][MAPSIZE * SEEY] ) {
+        std::array<const float ( * )[MAPSIZE *SEEX][MAPSIZE *SEEY], OVERMAP_LAYERS> transparency_caches;
+        std::array<float ( * )[MAPSIZE *SEEX][MAPSIZE *SEEY], OVERMAP_LAYERS> seen_caches;
+        std::array<const bool ( * )[MAPSIZE *SEEX][MAPSIZE *SEEY], OVERMAP_LAYERS> floor_caches;
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+            transparency_caches[z + OVERMAP_DEPTH] = &transparency_cache;
+            seen_caches[z + OVERMAP_DEPTH] = &seen;
+            floor_caches[z + OVERMAP_DEPTH] = &floor_cache;
+        }
+        std::fill_n( &seen[0][0], MAPSIZE * SEEX * MAPSIZE * SEEY, LIGHT_TRANSPARENCY_SOLID );
+        cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+            seen_caches, transparency_caches, floor_caches, origin, 0, 1.0 );
+    };
+    parallel_shadowcasting = false;
+    cast_3d( seen_sequential );
+    parallel_shadowcasting = true;
+    cast_3d( seen_parallel );
+    CHECK( std::equal( &seen_sequential[0][0], &seen_sequential[0][0] + MAPSIZE * SEEX * MAPSIZE * SEEY,
+                       &seen_parallel[0][0] ) );
+
+    parallel_shadowcasting = was_parallel;
+}
+
 // I'm not sure this will ever work.
 TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "catch/catch.hpp"
+#include "filesystem.h"
+#include "point.h"
+#include "submap_prefetcher.h"
+#include "submap_region.h"
+
+// Waits for the worker to finish reading the quad.
+static bool take_quad( submap_prefetcher &prefetcher, const tripoint &om_addr,
+                       submap_prefetcher::quad &result )
+{
+    for( int i = 0; i < 1000; i++ ) {
+        if( prefetcher.take( om_addr, result ) ) {
+            return true;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    }
+    return false;
+}
+
+TEST_CASE( "submap_prefetcher_reads_quads", "[submap_prefetcher]" )
+{
+    if( !submap_prefetcher::available() ) {
+        return;
+    }
+    const std::string map_directory = "tests/data/submap_prefetcher_maps";
+    const tripoint om_addr( 1, 2, 0 );
+    const std::string quad_file = quad_file_path( map_directory, om_addr );
+    const std::string quad_contents = "[{\"version\":27,\"coordinates\":[2,4,0]}]";
+    REQUIRE( assure_dir_exist( map_directory ) );
+    REQUIRE( assure_dir_exist( map_directory + "/0.0.0" ) );
+    {
+        std::ofstream fout( quad_file, std::ofstream::binary );
+        fout << quad_contents;
+    }
+    const std::string region_file = submap_region::path_for( map_directory, tripoint_zero );
+    submap_region::write( region_file, { { tripoint( 6, 0, 0 ), "{\"coordinates\":[6,0,0]}" } } );
+
+    submap_prefetcher prefetcher;
+    submap_prefetcher::quad result;
+
+    prefetcher.request( map_directory, om_addr );
+    REQUIRE( take_quad( prefetcher, om_addr, result ) );
+    CHECK( result.om_addr == om_addr );
+    CHECK( result.quad_file == quad_contents );
+    CHECK( result.region_records.empty() );
+
+    // Without a quad file, the records come from the region file.
+    prefetcher.request( map_directory, tripoint( 3, 0, 0 ) );
+    REQUIRE( take_quad( prefetcher, tripoint( 3, 0, 0 ), result ) );
+    CHECK( result.quad_file.empty() );
+    REQUIRE( result.region_records.size() == 1 );
+    CHECK( result.region_records.begin()->first == tripoint( 6, 0, 0 ) );
+
+    // Nothing saved at all.
+    prefetcher.request( map_directory, tripoint( 5, 5, 0 ) );
+    REQUIRE( take_quad( prefetcher, tripoint( 5, 5, 0 ), result ) );
+    CHECK( result.quad_file.empty() );
+    CHECK( result.region_records.empty() );
+
+    // Data read before the saved submaps changed is not handed out.
+    prefetcher.request( map_directory, om_addr );
+    prefetcher.discard();
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    CHECK_FALSE( prefetcher.take( om_addr, result ) );
+    CHECK( prefetcher.take_finished( 10 ).empty() );
+
+    prefetcher.request( map_directory, om_addr );
+    REQUIRE( take_quad( prefetcher, om_addr, result ) );
+    CHECK( result.quad_file == quad_contents );
+
+    remove_file( quad_file );
+    remove_file( region_file );
+    remove_directory( map_directory + "/0.0.0" );
+    remove_directory( map_directory );
+}
@@ -0,0 +1,145 @@
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "catch/catch.hpp"
+#include "filesystem.h"
+#include "point.h"
+#include "submap_region.h"
+
+TEST_CASE( "submap_region_round_trip", "[submap_region]" )
+{
+    const std::string path = "tests/data/submap_region_test.region";
+    const std::map<tripoint, std::string> records = {
+        { tripoint( 2, 4, 0 ), "{\"version\":27,\"coordinates\":[2,4,0]}" },
+        { tripoint( -3, 4, -1 ), "{\"version\":27,\"coordinates\":[-3,4,-1],\"terrain\":[]}" },
+    };
+    submap_region::write( path, records );
+
+    {
+        const submap_region region( path );
+        CHECK( region.size() == 2 );
+        CHECK( region.has( tripoint( -3, 4, -1 ) ) );
+        CHECK_FALSE( region.has( tripoint( 3, 4, 0 ) ) );
+        CHECK( region.record( tripoint( 2, 4, 0 ) ) == records.at( tripoint( 2, 4, 0 ) ) );
+        CHECK( region.record( tripoint( 3, 4, 0 ) ).empty() );
+
+        // Records already in the map are newer than those in the file.
+        std::map<tripoint, std::string> merged = { { tripoint( 2, 4, 0 ), "{}" } };
+        region.get_records( merged );
+        CHECK( merged.size() == 2 );
+        CHECK( merged.at( tripoint( 2, 4, 0 ) ) == "{}" );
+    }
+
+    remove_file( path );
+}
+
+static size_t file_size( const std::string &path )
+{
+    std::ifstream fin( path, std::ifstream::binary | std::ifstream::ate );
+    return static_cast<size_t>( fin.tellg() );
+}
+
+TEST_CASE( "submap_region_appends_changed_records", "[submap_region]" )
+{
+    const std::string path = "tests/data/submap_region_test.region";
+    const std::string unchanged( 4000, 'u' );
+    submap_region::write( path, {
+        { tripoint( 0, 0, 0 ), unchanged },
+        { tripoint( 1, 0, 0 ), "{\"old\":1}" },
+    } );
+    const size_t written_size = file_size( path );
+
+    submap_region::append( path, {
+        { tripoint( 1, 0, 0 ), "{\"new\":1}" },
+        { tripoint( 0, 1, 0 ), "{}" },
+    } );
+    {
+        const submap_region region( path );
+        CHECK( region.size() == 3 );
+        CHECK( region.has_record( tripoint( 0, 0, 0 ), unchanged ) );
+        CHECK( region.record( tripoint( 1, 0, 0 ) ) == "{\"new\":1}" );
+        CHECK_FALSE( region.has_record( tripoint( 1, 0, 0 ), "{\"old\":1}" ) );
+        CHECK( region.record( tripoint( 0, 1, 0 ) ) == "{}" );
+    }
+    // Only the new records and the index were added, the unchanged record was not copied.
+    CHECK( file_size( path ) < written_size + unchanged.size() );
+
+    // Replacing the same record over and over eventually rewrites the file.
+    for( int i = 0; i < 10; i++ ) {
+        submap_region::append( path, { { tripoint( 1, 0, 0 ), std::string( 1000, 'a' + i ) } } );
+    }
+    CHECK( file_size( path ) < 2 * ( unchanged.size() + 1000 + 2 ) + 200 );
+    {
+        const submap_region region( path );
+        CHECK( region.size() == 3 );
+        CHECK( region.has_record( tripoint( 0, 0, 0 ), unchanged ) );
+        CHECK( region.has_record( tripoint( 1, 0, 0 ), std::string( 1000, 'j' ) ) );
+    }
+
+    remove_file( path );
+}
+
+TEST_CASE( "submap_region_rejects_invalid_files", "[submap_region]" )
+{
+    const std::string path = "tests/data/submap_region_test.region";
+    {
+        std::ofstream fout( path, std::ofstream::binary );
+        fout << "[{\"version\":27}]";
+    }
+    CHECK_THROWS_AS( submap_region( path ), std::runtime_error );
+
+    submap_region::write( path, { { tripoint( 0, 0, 0 ), "{}" } } );
+    {
+        // Cut off the record.
+        std::string contents;
+        {
+            std::ifstream fin( path, std::ifstream::binary );
+            contents.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+        }
+        std::ofstream fout( path, std::ofstream::binary );
+        fout << contents.substr( 0, contents.size() - 1 );
+    }
+    CHECK_THROWS_AS( submap_region( path ), std::runtime_error );
+
+    remove_file( path );
+}
+
+TEST_CASE( "submap_region_converts_quad_files", "[submap_region]" )
+{
+    const std::string map_directory = "tests/data/submap_region_maps";
+    const std::string quad_file = map_directory + "/0.0.0/1.2.0.map";
+    const std::string quad_contents =
+        "[{\"version\":27,\"coordinates\":[2,4,0],\"terrain\":[\"t_dirt\"]},"
+        "{\"version\":27,\"coordinates\":[3,4,0],\"note\":\"}\"}]";
+    REQUIRE( assure_dir_exist( map_directory ) );
+    REQUIRE( assure_dir_exist( map_directory + "/0.0.0" ) );
+    {
+        std::ofstream fout( quad_file, std::ofstream::binary );
+        fout << quad_contents;
+    }
+
+    CHECK( convert_quads_to_regions( map_directory ) == 2 );
+    CHECK_FALSE( file_exist( quad_file ) );
+    const std::string region_file = submap_region::path_for( map_directory, tripoint_zero );
+    {
+        const submap_region region( region_file );
+        CHECK( region.record( tripoint( 3, 4, 0 ) ) ==
+               "{\"version\":27,\"coordinates\":[3,4,0],\"note\":\"}\"}" );
+    }
+
+    CHECK( convert_regions_to_quads( map_directory ) == 2 );
+    CHECK_FALSE( file_exist( region_file ) );
+    std::string contents;
+    {
+        std::ifstream fin( quad_file, std::ifstream::binary );
+        contents.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+    }
+    CHECK( contents == quad_contents );
+
+    remove_file( quad_file );
+    remove_directory( map_directory + "/0.0.0" );
+    remove_directory( map_directory );
+}
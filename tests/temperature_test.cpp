@@ -1,4 +1,5 @@
 #include <set>
+#include <vector>
 
 #include "catch/catch.hpp"
 #include "calendar.h"
@@ -9,6 +10,8 @@
 #include "enums.h"
 #include "cata_utility.h"
 #include "game.h"
+#include "weather.h"
+#include "weather_gen.h"
 
 
 static bool is_nearly( float value, float expected )
@@ -294,3 +297,77 @@ TEST_CASE( "Temperature controlled location" )
         CHECK( is_nearly( water1.temperature, 100000 * temp_to_kelvin( temperatures::normal ) ) );
     }
 }
+
+TEST_CASE( "Items catching up on a long time in a freezer" )
+{
+    // Frozen food doesn't rot. Processing it after days in a freezer skips the hours in
+    // which only the temperature changes, the food must still stay frozen and not rot.
+    item meat1( "meat_cooked" );
+    item meat2( "meat_cooked" );
+
+    tripoint pos = tripoint( 0, 0, 0 );
+    set_map_temperature( 0 ); // -17 C
+
+    meat1.process_temperature_rot( 1, pos, nullptr, temperature_flag::TEMP_FREEZER );
+    meat2.process_temperature_rot( 1, pos, nullptr, temperature_flag::TEMP_FREEZER );
+    REQUIRE( meat1.item_tags.count( "FROZEN" ) );
+    const time_duration rot = meat1.get_rot();
+
+    // meat1 is processed every hour, meat2 only once at the end.
+    const time_point start = calendar::turn;
+    while( calendar::turn < start + 10_days ) {
+        calendar::turn = to_turn<int>( calendar::turn + 1_hours );
+        meat1.process_temperature_rot( 1, pos, nullptr, temperature_flag::TEMP_FREEZER );
+    }
+    meat2.process_temperature_rot( 1, pos, nullptr, temperature_flag::TEMP_FREEZER );
+
+    CHECK( meat1.item_tags.count( "FROZEN" ) );
+    CHECK( meat2.item_tags.count( "FROZEN" ) );
+    CHECK( meat1.get_rot() == rot );
+    CHECK( meat2.get_rot() == rot );
+}
+
+TEST_CASE( "Cached weather history matches the weather generator" )
+{
+    const tripoint pos = tripoint( 0, 0, 0 );
+    const weather_generator &wgen = g->weather.get_cur_weather_gen();
+    const time_point start = calendar::turn;
+
+    // Looked up twice, the second one comes from the cache.
+    for( time_point t = start; t < start + 2_days; t += 5_hours + 7_minutes ) {
+        const double expected = wgen.get_weather( pos, t, g->get_seed() ).temperature;
+        CHECK( g->weather.get_weather_temperature( pos, t ) == expected );
+        CHECK( g->weather.get_weather_temperature( pos, t ) == expected );
+        CHECK( g->weather.get_weather_temperature( pos + tripoint( 3, 0, 0 ), t ) ==
+               wgen.get_weather( pos + tripoint( 3, 0, 0 ), t, g->get_seed() ).temperature );
+    }
+}
+
+TEST_CASE( "Items on one tile share the weather history they catch up on" )
+{
+    const tripoint pos = tripoint( 0, 0, 0 );
+    set_map_temperature( 65 );
+    const time_point start = calendar::turn;
+
+    // Last processed together, like the items of a pile.
+    std::vector<item> items;
+    for( int i = 0; i < 10; i++ ) {
+        items.emplace_back( "meat_cooked" );
+        items.back().reset_temp_check();
+    }
+
+    calendar::turn = to_turn<int>( start + 3_days );
+    const weather_manager::weather_cache_stats before =
+        g->weather.get_weather_temperature_cache_stats();
+    for( item &it : items ) {
+        it.process_temperature_rot( 1, pos, nullptr );
+    }
+    weather_manager::weather_cache_stats stats = g->weather.get_weather_temperature_cache_stats();
+    stats.lookups -= before.lookups;
+    stats.hits -= before.hits;
+    INFO( stats.hits << " hits in " << stats.lookups << " lookups" );
+    // The first item generates the weather of every hour, the others find it in the cache.
+    CHECK( stats.lookups >= 10 * 70 );
+    CHECK( stats.hits >= stats.lookups * 8 / 10 );
+    calendar::turn = to_turn<int>( start );
+}
@@ -0,0 +1,29 @@
+#include <atomic>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "thread_pool.h"
+
+TEST_CASE( "thread_pool_runs_every_task_once", "[thread_pool]" )
+{
+    thread_pool pool( 3 );
+    CHECK( pool.size() >= 1 );
+
+    for( const int num_tasks : {
+             0, 1, 2, 7, 100
+         } ) {
+        std::vector<std::atomic<int>> runs( num_tasks );
+        for( std::atomic<int> &count : runs ) {
+            count = 0;
+        }
+        // Several batches in a row, workers have to pick up each of them.
+        for( int batch = 0; batch < 10; batch++ ) {
+            pool.run( num_tasks, [&]( const int task ) {
+                runs[task]++;
+            } );
+        }
+        for( int task = 0; task < num_tasks; task++ ) {
+            CHECK( runs[task] == 10 );
+        }
+    }
+}
@@ -3,9 +3,11 @@
 
 #include "avatar.h"
 #include "catch/catch.hpp"
+#include "coordinate_conversions.h"
 #include "game.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "mapbuffer.h"
 #include "player.h"
 #include "vehicle.h"
 #include "enums.h"
@@ -45,3 +47,21 @@ TEST_CASE( "destroy_grabbed_vehicle_section" )
         }
     }
 }
+
+TEST_CASE( "vehicle_registry_tracks_submaps_with_vehicles" )
+{
+    clear_map();
+    const tripoint vehicle_origin( 60, 60, 0 );
+    const tripoint sm_pos = ms_to_sm_copy( g->m.getabs( vehicle_origin ) );
+    const auto &registered = MAPBUFFER.get_submaps_with_vehicles();
+    REQUIRE( registered.count( sm_pos ) == 0 );
+
+    vehicle *veh_ptr = g->m.add_vehicle( vproto_id( "bicycle" ), vehicle_origin, -90, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    const tripoint veh_sm_pos( g->m.get_abs_sub().x + veh_ptr->smx,
+                               g->m.get_abs_sub().y + veh_ptr->smy, veh_ptr->smz );
+    CHECK( registered.count( veh_sm_pos ) == 1 );
+
+    g->m.detach_vehicle( veh_ptr );
+    CHECK( registered.count( veh_sm_pos ) == 0 );
+}
@@ -488,3 +488,34 @@ TEST_CASE( "vision_see_wall_in_moonlight", "[shadowcasting][vision]" )
 
     t.test_all();
 }
+
+TEST_CASE( "lightmap_follows_local_changes", "[shadowcasting][vision]" )
+{
+    g->place_player( tripoint( 60, 60, 0 ) );
+    g->u.worn.clear();
+    clear_map();
+    g->reset_light_level();
+    calendar::turn = midnight;
+
+    const ter_id t_utility_light( "t_utility_light" );
+    const ter_id t_brick_wall( "t_brick_wall" );
+    const tripoint light( 60, 50, 0 );
+    const tripoint lit( 60, 56, 0 );
+    const tripoint between( 60, 53, 0 );
+    const ter_id old_terrain = g->m.ter( between );
+
+    g->m.ter_set( light, t_utility_light );
+    g->m.invalidate_map_cache( light.z );
+    g->m.build_map_cache( light.z );
+    const float light_level = g->m.ambient_light_at( lit );
+    REQUIRE( light_level > LIGHT_AMBIENT_LIT );
+
+    // Only the changed submap is rebuilt, the light has to be cast again anyway
+    g->m.ter_set( between, t_brick_wall );
+    g->m.build_map_cache( light.z );
+    CHECK( g->m.ambient_light_at( lit ) < LIGHT_AMBIENT_LIT );
+
+    g->m.ter_set( between, old_terrain );
+    g->m.build_map_cache( light.z );
+    CHECK( g->m.ambient_light_at( lit ) == Approx( light_level ) );
+}